@@ -47,6 +47,24 @@ namespace great
 		}
 	}
 
+	void t_gprecisebias::set_sat_state(shared_ptr<t_gsatstate> sat_state)
+	{
+		gmodel.set_sat_state(sat_state);
+		for (auto& site_model : _map_site_model)
+		{
+			site_model.second->set_sat_state(sat_state);
+		}
+	}
+
+	void t_gprecisebias::set_trs2crs_table(shared_ptr<t_gtrs2crs_table> trs2crs_table)
+	{
+		gmodel.set_trs2crs_table(trs2crs_table);
+		for (auto& site_model : _map_site_model)
+		{
+			site_model.second->set_trs2crs_table(trs2crs_table);
+		}
+	}
+
     bool t_gprecisebias::cmb_equ(t_gtime& epoch,t_gallpar& params,t_gsatdata& obsdata,t_gobs& gobs,t_gbaseEquation& result)
     {
         // check obs_type valid
@@ -51,6 +51,12 @@ namespace great
         ~t_gprecisebias();
 
 		void set_multi_thread(const set<string>& sites);
+
+		/** @brief share the satellite states of the epoch with the models of all sites */
+		void set_sat_state(shared_ptr<t_gsatstate> sat_state);
+
+		/** @brief share the precomputed TRS2CRS rotations with the models of all sites */
+		void set_trs2crs_table(shared_ptr<t_gtrs2crs_table> trs2crs_table);
         /** @brief Combined equation */
         bool cmb_equ(t_gtime& epoch,t_gallpar& params,t_gsatdata& obsdata,t_gobs& gobs,t_gbaseEquation& result) override;
         void update_obj_clk(const string& obj, const t_gtime& epo, double clk) override;
@@ -260,38 +260,10 @@ namespace great
 		for (auto& iter : all_obs)
 		{
 			const string& obs_rec = iter.site();
-			const string& obs_sat = iter.sat();
 
 			if (obs_rec != rec) continue;
 
-			bool obs_valid = true;
-			if (_lite_turboedit)
-			{
-				set<GOBSBAND> band_avail = iter.band_avail();
-				bool freq1_ok = false;
-				for (auto itband : band_avail)
-				{
-					FREQ_SEQ freq2 = _freq_index[iter.gsys()][itband];
-					switch (freq2)
-					{
-					case FREQ_SEQ::FREQ_1:
-						freq1_ok = true;
-						break;
-					case FREQ_SEQ::FREQ_2:
-						iter.tb12(true);
-						break;
-					default:
-						break;
-					}
-				}
-				if (!freq1_ok)
-				{
-					iter.tb12(false);
-				}
-				
-			}
-
-			if (iter.tb12())
+			if (_use_rec_obs(iter))
 			{
 				rec_obs.push_back(iter);
 			}
@@ -307,6 +279,50 @@ namespace great
 		return true;
 	}
 
+	bool t_glsqproc::_select_rec_obs(const string& rec, const t_gtime& epoch, vector<t_gsatdata>& rec_obs)
+	{
+		rec_obs.erase(remove_if(rec_obs.begin(), rec_obs.end(),
+			[this](t_gsatdata& obs) { return !_use_rec_obs(obs); }), rec_obs.end());
+
+		if (rec_obs.empty())
+		{
+			_glog->logDebug("t_glsqproc", "_select_rec_obs", "This epoch have no useful data : " + rec);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool t_glsqproc::_use_rec_obs(t_gsatdata& obs)
+	{
+		if (_lite_turboedit)
+		{
+			set<GOBSBAND> band_avail = obs.band_avail();
+			bool freq1_ok = false;
+			for (auto itband : band_avail)
+			{
+				FREQ_SEQ freq2 = _freq_index[obs.gsys()][itband];
+				switch (freq2)
+				{
+				case FREQ_SEQ::FREQ_1:
+					freq1_ok = true;
+					break;
+				case FREQ_SEQ::FREQ_2:
+					obs.tb12(true);
+					break;
+				default:
+					break;
+				}
+			}
+			if (!freq1_ok)
+			{
+				obs.tb12(false);
+			}
+		}
+
+		return obs.tb12();
+	}
+
 	bool t_glsqproc::_processOneEpoch(const t_gtime& crt_epoch, std::vector<t_gsatdata>& crt_obs)
 	{
 		// ========================================================================================================================================
@@ -750,6 +766,11 @@ namespace great
 		omp_set_num_threads(_num_threads);
 #endif
 		_matrix_remove = dynamic_cast<t_gsetproc*>(set)->matrix_remove();
+		_neq_thread_reduce = dynamic_cast<t_gsetproc*>(set)->neq_thread_reduce();
+		_sat_state_cache = dynamic_cast<t_gsetproc*>(set)->sat_state_cache();
+		_trs2crs_interp = dynamic_cast<t_gsetproc*>(set)->trs2crs_interp();
+		_trs2crs_accuracy = dynamic_cast<t_gsetproc*>(set)->trs2crs_accuracy();
+		_obs_store = dynamic_cast<t_gsetproc*>(set)->obs_store();
 
 		_maxres_norm = dynamic_cast<t_gsetproc*>(set)->max_res_norm();
 		_band_index[gnut::GPS] = dynamic_cast<t_gsetgnss*>(set)->band_index(gnut::GPS);
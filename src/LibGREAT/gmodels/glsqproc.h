@@ -151,6 +151,14 @@ class LibGREAT_LIBRARY_EXPORT t_glsqproc {
   int _num_threads = 1;
   bool _matrix_remove = false;
   bool _cmb_equ_multi_thread = false;
+  bool _neq_thread_reduce = false;
+  bool _sat_state_cache = false;
+  shared_ptr<t_gsatstate> _sat_state;   ///< satellite states of the epoch shared by all sites
+  bool _trs2crs_interp = false;
+  double _trs2crs_accuracy = 1e-11;
+  shared_ptr<t_gtrs2crs_table> _trs2crs_table;   ///< TRS2CRS rotations of the processing window
+  bool _obs_store = false;
+  shared_ptr<t_gobsstore> _gobs_store;   ///< columnar copy of the observations of _rec_list (read by ProcessBatch, the maps released)
 
   int _cmb_equ_msec{};
   int _remove_par_msec{};
@@ -194,6 +202,10 @@ class LibGREAT_LIBRARY_EXPORT t_glsqproc {
                        const t_gtime &epoch,
                        vector<t_gsatdata> &all_obs,
                        vector<t_gsatdata> &rec_obs);
+  /** @brief select receiver current epoch obs in place */
+  bool _select_rec_obs(const string &rec, const t_gtime &epoch, vector<t_gsatdata> &rec_obs);
+  /** @brief set tb12 of lite turboedit and return whether the obs is used */
+  bool _use_rec_obs(t_gsatdata &obs);
   /** @brief init satellite clock */
   bool _init_sat_clk_IF(vector<t_gsatdata> &crt_obs, ColumnVector &l, t_glsq *lsq);
   bool _init_sat_clk();
@@ -0,0 +1,111 @@
+/**
+ * @file         gobsworkspace.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        per-epoch observations of all sites, reused over the epochs
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gmodels/gobsworkspace.h"
+
+#include <map>
+
+namespace great
+{
+	t_gobsworkspace::t_gobsworkspace()
+	{
+	}
+
+	t_gobsworkspace::~t_gobsworkspace()
+	{
+	}
+
+	void t_gobsworkspace::fill(t_gallobs* allobs, const set<string>& sites, const t_gtime& t)
+	{
+		allobs->obs_view(sites, t, _view);
+
+		_sites = _view.sites;
+		_obs.resize(_sites.size());
+		for (size_t i = 0; i < _sites.size(); i++)
+		{
+			_obs[i].clear();
+			_obs[i].reserve(_view.size(i));
+			for (size_t k = _view.beg[i]; k < _view.beg[i + 1]; k++)
+			{
+				_obs[i].emplace_back(*_view.obs[k]);
+			}
+		}
+	}
+
+	void t_gobsworkspace::fill(const t_gobsstore& store, const set<string>& sites, const t_gtime& t)
+	{
+		_sites.assign(sites.begin(), sites.end());
+		_obs.resize(_sites.size());
+		for (size_t i = 0; i < _sites.size(); i++)
+		{
+			t_gobsepoch epoch = store.epoch(_sites[i], t);
+			_obs[i].clear();
+			_obs[i].reserve(epoch.size());
+			for (const auto& row : epoch)
+			{
+				// built as decoded, the same t_gsatdata as from the t_gallobs view
+				t_gobsgnss one_obs(row.site(), row.sat(), row.epoch());
+				row.get(one_obs);
+				_obs[i].emplace_back(one_obs);
+			}
+		}
+	}
+
+	void t_gobsworkspace::fill(const vector<t_gsatdata>& obs, const set<string>& sites)
+	{
+		_sites.assign(sites.begin(), sites.end());
+		_obs.resize(_sites.size());
+
+		map<string, int> index;
+		for (size_t i = 0; i < _sites.size(); i++)
+		{
+			_obs[i].clear();
+			index[_sites[i]] = (int)i;
+		}
+		for (const auto& one_obs : obs)
+		{
+			auto iter = index.find(one_obs.site());
+			if (iter != index.end()) _obs[iter->second].push_back(one_obs);
+		}
+	}
+
+	size_t t_gobsworkspace::num_obs() const
+	{
+		size_t num = 0;
+		for (const auto& site_obs : _obs) num += site_obs.size();
+		return num;
+	}
+
+	set<string> t_gobsworkspace::sats() const
+	{
+		set<string> all_sats;
+		for (const auto& site_obs : _obs)
+		{
+			for (const auto& one_obs : site_obs) all_sats.insert(one_obs.sat());
+		}
+		return all_sats;
+	}
+
+	vector<t_gsatdata>& t_gobsworkspace::gather()
+	{
+		size_t num = 0;
+		for (const auto& site_obs : _obs)
+		{
+			for (const auto& one_obs : site_obs)
+			{
+				if (num < _all.size()) _all[num] = one_obs;
+				else _all.push_back(one_obs);
+				num++;
+			}
+		}
+		_all.erase(_all.begin() + num, _all.end());
+		return _all;
+	}
+}
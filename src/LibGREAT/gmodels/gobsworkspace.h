@@ -0,0 +1,81 @@
+/**
+ * @file         gobsworkspace.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        per-epoch observations of all sites, reused over the epochs
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GOBSWORKSPACE_H
+#define GOBSWORKSPACE_H
+
+#include "gexport/ExportLibGREAT.h"
+#include "gall/gallobs.h"
+#include "gall/gobsstore.h"
+#include "gdata/gsatdata.h"
+#include "gutils/gtime.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace gnut;
+
+namespace great
+{
+	/**
+	* @brief observations of one epoch, one vector per site
+	* @note the t_gsatdata of a site are built once from the t_gallobs view (or the store) and then selected,
+	*       corrected and used in place. All vectors keep their capacity over the epochs.
+	*/
+	class LibGREAT_LIBRARY_EXPORT t_gobsworkspace
+	{
+	public:
+		/** @brief default constructor */
+		t_gobsworkspace();
+
+		/** @brief default destructor */
+		~t_gobsworkspace();
+
+		/** @brief take the obs of sites at epoch t from allobs */
+		void fill(t_gallobs* allobs, const set<string>& sites, const t_gtime& t);
+
+		/** @brief take the obs of sites at epoch t from the columnar store */
+		void fill(const t_gobsstore& store, const set<string>& sites, const t_gtime& t);
+
+		/** @brief distribute obs of sites (e.g. from t_gallobs::obs) to the sites */
+		void fill(const vector<t_gsatdata>& obs, const set<string>& sites);
+
+		/** @brief number of sites */
+		int size() const { return (int)_sites.size(); }
+
+		/** @brief site i */
+		const string& site(int i) const { return _sites[i]; }
+
+		/** @brief obs of site i, may be edited in place */
+		vector<t_gsatdata>& obs(int i) { return _obs[i]; }
+
+		/** @brief number of obs of all sites */
+		size_t num_obs() const;
+
+		/** @brief satellites of all sites */
+		set<string> sats() const;
+
+		/**
+		* @brief obs of all sites in one vector, as needed by t_glsq::update_parameter
+		* @note the elements of the previous epoch are overwritten
+		*/
+		vector<t_gsatdata>& gather();
+
+	private:
+		t_gobsview _view;                   ///< pointers into t_gallobs
+		vector<string> _sites;              ///< sites
+		vector<vector<t_gsatdata> > _obs;   ///< obs of each site
+		vector<t_gsatdata> _all;            ///< obs of all sites
+	};
+}
+
+#endif // !GOBSWORKSPACE_H
@@ -432,7 +432,9 @@ namespace great
 		// update clk
 		if (obj_clk[name].first != crt_epoch)
 		{
-			int clk_valid = _gall_nav->clk(name, crt_epoch, &clk, &clk_rms, &dclk);
+			int clk_valid = -1;
+			if (type == "sat" && _sat_state && _sat_state->clk(name, crt_epoch, clk)) clk_valid = 1;
+			else clk_valid = _gall_nav->clk(name, crt_epoch, &clk, &clk_rms, &dclk);
 			if (clk_valid < 0) {
 				if (type == "sat" && idx_clk >= 0) return false;
 				clk = 0.0;
@@ -1136,7 +1138,10 @@ namespace great
 		if (find_iter == _trs2crs_list.end())
 		{
 			_trs2crs_2000 = make_shared<t_gtrs2crs>(false, _gdata_erp);
-			_trs2crs_2000->calcRotMat(tdt, true, true, true);
+			if (!_trs2crs_table || !_trs2crs_table->interpolate(tdt, *_trs2crs_2000))
+			{
+				_trs2crs_2000->calcRotMat(tdt, true, true, true);
+			}
 			_trs2crs_list.insert(make_pair(tdt, _trs2crs_2000));
 
 			auto before_iter = _trs2crs_list.lower_bound(tdt - 300.0);
@@ -1233,7 +1238,8 @@ namespace great
 			sat_epo = rec_epo - delay;
 
 			// Get CRS
-			bool sat_pos_valid = _get_crs_sat_crd(sat_epo, _crt_sat, _crs_sat_crd);
+			bool sat_pos_valid = (_sat_state && _sat_state->crs_crd(_crt_sat, sat_epo, _crs_sat_crd));
+			if (!sat_pos_valid) sat_pos_valid = _get_crs_sat_crd(sat_epo, _crt_sat, _crs_sat_crd);
 			if (!sat_pos_valid)
 			{
 				write_log_info(_log, 1, "NOTE", "can not get sat pos for " + _crt_sat);
@@ -1354,10 +1360,14 @@ namespace great
 		}
 
 		// get vel in CRS
-		double xyz0[3], xyz1[3];
-		if (!_gall_nav->pos(sat, sat_epoch, xyz0)) return false;
-		if (!_gall_nav->pos(sat, sat_epoch + 1, xyz1)) return false;
-		t_gtriple vel_trs(xyz1[0]- xyz0[0], xyz1[1] - xyz0[1], xyz1[2] - xyz0[2]);
+		t_gtriple vel_trs;
+		if (!_sat_state || !_sat_state->trs_diff(sat, sat_epoch, vel_trs))
+		{
+			double xyz0[3], xyz1[3];
+			if (!_gall_nav->pos(sat, sat_epoch, xyz0)) return false;
+			if (!_gall_nav->pos(sat, sat_epoch + 1, xyz1)) return false;
+			vel_trs = t_gtriple(xyz1[0] - xyz0[0], xyz1[1] - xyz0[1], xyz1[2] - xyz0[2]);
+		}
 		ColumnVector x_earth = (_crs_sat_crd.crd_cvect().t() * _trs2crs_2000->getMatDu() / RAD2TSEC).t();
 		sat_vel = t_gtriple(_trs2crs_2000->getRotMat() * (vel_trs.crd_cvect() + x_earth));
 
@@ -19,6 +19,8 @@
 #include "gall/gallproc.h"
 #include "gdata/gpoleut1.h"
 #include "gutils/gtrs2crs.h"
+#include "gutils/gtrs2crstable.h"
+#include "gmodels/gsatstate.h"
 #include "gdata/gnavde.h"
 #include "gset/gsetproc.h"
 
@@ -52,6 +54,18 @@ namespace great
 
 		void set_multi_debug_output(string filename);
 
+		/**
+		* @brief share the satellite states of the epoch
+		* @param[in] sat_state states computed once for all sites, nullptr to compute them in the model
+		*/
+		void set_sat_state(shared_ptr<t_gsatstate> sat_state) { _sat_state = sat_state; }
+
+		/**
+		* @brief share the precomputed TRS2CRS rotations
+		* @param[in] trs2crs_table table built for the processing window, nullptr to compute them in the model
+		*/
+		void set_trs2crs_table(shared_ptr<t_gtrs2crs_table> trs2crs_table) { _trs2crs_table = trs2crs_table; }
+
 		bool _prepare_obs(const t_gtime& epoch, t_gallpar& pars);
 		bool _omc_obs_ALL(const t_gtime& crt_epo, t_gallpar& pars, t_gobs& gobs,  double& omc);
 		bool _wgt_obs_ALL(t_gobs& gobs1, double factorP, double& wgt);
@@ -210,6 +224,10 @@ namespace great
 		t_gnavde *      _gdata_navde  = nullptr;	  ///< all panetnav info
 		shared_ptr<t_gtide> _tide ;				      ///< tide correction model
 
+		shared_ptr<t_gsatstate> _sat_state;   ///< satellite states shared by all sites
+
+		shared_ptr<t_gtrs2crs_table> _trs2crs_table;   ///< TRS2CRS rotations shared by all sites
+
 		map<t_gtime, shared_ptr<t_gtrs2crs> > _trs2crs_list;
 		shared_ptr<t_gtrs2crs>    _trs2crs_2000;	  ///< trs2crs matrix
 
@@ -0,0 +1,148 @@
+/**
+ * @file         gsatstate.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        satellite states of one epoch shared by all site models
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gmodels/gsatstate.h"
+#include "gutils/gtrs2crs.h"
+#include "gutils/gconst.h"
+#include "gutils/gtypeconv.h"
+
+#include <vector>
+#include <cmath>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace great
+{
+	t_gsatstate::t_gsatstate(t_gallnav* nav, t_gpoleut1* erp, double max_dt) :
+		_nav(nav),
+		_erp(erp),
+		_max_dt(max_dt),
+		_epoch(FIRST_TIME)
+	{
+	}
+
+	t_gsatstate::~t_gsatstate()
+	{
+	}
+
+	void t_gsatstate::update(const t_gtime& epoch, const set<string>& sats)
+	{
+		if (epoch == _epoch) return;
+
+		_epoch = epoch;
+		_states.clear();
+		if (!_nav || !_erp || _erp->isEmpty()) return;
+
+		vector<string> vec_sats(sats.begin(), sats.end());
+		vector<t_gsatstate_item> items(vec_sats.size());
+		vector<char> valid(vec_sats.size(), 0);
+
+		// each sat writes only its own slot
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int i = 0; i < (int)vec_sats.size(); i++)
+		{
+			valid[i] = _compute(vec_sats[i], epoch, items[i]);
+		}
+
+		for (unsigned int i = 0; i < vec_sats.size(); i++)
+		{
+			if (valid[i]) _states[vec_sats[i]] = items[i];
+		}
+	}
+
+	bool t_gsatstate::crs_crd(const string& sat, const t_gtime& sat_epo, t_gtriple& crd) const
+	{
+		double dt = 0.0;
+		const t_gsatstate_item* item = _find(sat, sat_epo, dt);
+		if (!item) return false;
+
+		crd = item->crs_crd + item->crs_dot * dt + item->crs_ddot * (0.5 * dt * dt);
+		return true;
+	}
+
+	bool t_gsatstate::trs_diff(const string& sat, const t_gtime& sat_epo, t_gtriple& diff) const
+	{
+		double dt = 0.0;
+		const t_gsatstate_item* item = _find(sat, sat_epo, dt);
+		if (!item) return false;
+
+		// integral of the velocity over [dt, dt+1]
+		diff = item->trs_dot + item->trs_ddot * (dt + 0.5);
+		return true;
+	}
+
+	bool t_gsatstate::clk(const string& sat, const t_gtime& epoch, double& clk) const
+	{
+		if (epoch != _epoch) return false;
+
+		auto iter = _states.find(sat);
+		if (iter == _states.end() || !iter->second.clk_valid) return false;
+
+		clk = iter->second.clk;
+		return true;
+	}
+
+	bool t_gsatstate::_compute(const string& sat, const t_gtime& epoch, t_gsatstate_item& item) const
+	{
+		// nominal light time from the geocenter-surface distance
+		double xyz[3];
+		if (_nav->pos(sat, epoch, xyz) < 0) return false;
+		double radius = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1] + xyz[2] * xyz[2]);
+		if (radius <= R_SPHERE) return false;
+		item.ref = epoch - (radius - R_SPHERE) / CLIGHT;
+
+		// samples at ref-1s, ref, ref+1s
+		t_gtriple trs[3], crs[3];
+		for (int i = 0; i < 3; i++)
+		{
+			t_gtime t = item.ref + (i - 1.0);
+			if (_nav->pos(sat, t, xyz) < 0) return false;
+			trs[i] = t_gtriple(xyz);
+			if (double_eq(xyz[0] * xyz[1] * xyz[2], 0.0)) return false;
+
+			// as t_gprecisemodel::_update_rot_matrix
+			t_gtime tdt = t;
+			tdt.tsys(t_gtime::TT);
+			t_gtrs2crs trs2crs(false, _erp);
+			if (!_trs2crs_table || !_trs2crs_table->interpolate(tdt, trs2crs))
+			{
+				trs2crs.calcRotMat(tdt, true, true, true);
+			}
+			crs[i] = t_gtriple(trs2crs.getRotMat() * trs[i].crd_cvect());
+		}
+
+		item.crs_crd = crs[1];
+		item.crs_dot = (crs[2] - crs[0]) * 0.5;
+		item.crs_ddot = crs[2] - crs[1] * 2.0 + crs[0];
+		item.trs_dot = (trs[2] - trs[0]) * 0.5;
+		item.trs_ddot = trs[2] - trs[1] * 2.0 + trs[0];
+
+		// clock at the epoch, as t_gprecisemodel::_update_obj_clk
+		double clk_rms = 0.0, dclk = 0.0;
+		item.clk_valid = _nav->clk(sat, epoch, &item.clk, &clk_rms, &dclk) >= 0;
+		if (!item.clk_valid) item.clk = 0.0;
+
+		return true;
+	}
+
+	const t_gsatstate_item* t_gsatstate::_find(const string& sat, const t_gtime& sat_epo, double& dt) const
+	{
+		auto iter = _states.find(sat);
+		if (iter == _states.end()) return nullptr;
+
+		dt = sat_epo.diff(iter->second.ref);
+		if (fabs(dt) > _max_dt) return nullptr;
+		return &iter->second;
+	}
+}
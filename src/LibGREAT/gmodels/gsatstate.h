@@ -0,0 +1,106 @@
+/**
+ * @file         gsatstate.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        satellite states of one epoch shared by all site models
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GSATSTATE_H
+#define GSATSTATE_H
+
+#include "gexport/ExportLibGREAT.h"
+#include "gutils/gtime.h"
+#include "gutils/gtriple.h"
+#include "gall/gallnav.h"
+#include "gdata/gpoleut1.h"
+#include "gutils/gtrs2crstable.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace std;
+using namespace gnut;
+
+namespace great
+{
+	/**
+	* @brief state of one satellite around its nominal transmit time
+	* @note positions are expanded to second order from samples at ref-1s, ref, ref+1s
+	*/
+	struct t_gsatstate_item
+	{
+		t_gtime   ref;                 ///< nominal transmit time
+		t_gtriple crs_crd;             ///< CRS position at ref [m]
+		t_gtriple crs_dot;             ///< CRS velocity at ref [m/s]
+		t_gtriple crs_ddot;            ///< CRS acceleration at ref [m/s^2]
+		t_gtriple trs_dot;             ///< TRS velocity at ref [m/s]
+		t_gtriple trs_ddot;            ///< TRS acceleration at ref [m/s^2]
+		double    clk = 0.0;           ///< clock at the epoch [s]
+		bool      clk_valid = false;   ///< clock found
+	};
+
+	/**
+	* @brief satellite states of the current epoch, computed once per satellite
+	*        and shared read-only by the models of all sites
+	* @note the nominal transmit time is the epoch minus the light time from the
+	*       geocenter-surface distance. Sites read the position at their own transmit
+	*       time within max_dt [s] of it, other requests return false and the
+	*       caller computes the state itself.
+	*/
+	class LibGREAT_LIBRARY_EXPORT t_gsatstate
+	{
+	public:
+		/**
+		* @brief constructor
+		* @param[in] nav orbits and clocks
+		* @param[in] erp poleut1 data for TRS2CRS
+		* @param[in] max_dt max distance [s] from the nominal transmit time
+		*/
+		t_gsatstate(t_gallnav* nav, t_gpoleut1* erp, double max_dt = 0.5);
+
+		/** @brief default destructor */
+		~t_gsatstate();
+
+		/**
+		* @brief compute the states of sats for the epoch, in parallel over sats
+		* @note not thread safe, call it before the site loop
+		*/
+		void update(const t_gtime& epoch, const set<string>& sats);
+
+		/** @brief use the precomputed TRS2CRS rotations, nullptr to compute them directly */
+		void set_trs2crs_table(shared_ptr<t_gtrs2crs_table> trs2crs_table) { _trs2crs_table = trs2crs_table; }
+
+		/** @brief epoch of the states */
+		const t_gtime& epoch() const { return _epoch; }
+
+		/** @brief CRS position at the transmit time sat_epo */
+		bool crs_crd(const string& sat, const t_gtime& sat_epo, t_gtriple& crd) const;
+
+		/** @brief TRS position difference pos(sat_epo+1s) - pos(sat_epo) */
+		bool trs_diff(const string& sat, const t_gtime& sat_epo, t_gtriple& diff) const;
+
+		/** @brief clock of sat at the epoch of the states */
+		bool clk(const string& sat, const t_gtime& epoch, double& clk) const;
+
+	private:
+		/** @brief compute the state of one sat */
+		bool _compute(const string& sat, const t_gtime& epoch, t_gsatstate_item& item) const;
+
+		/** @brief state of sat if sat_epo is within max_dt */
+		const t_gsatstate_item* _find(const string& sat, const t_gtime& sat_epo, double& dt) const;
+
+		t_gallnav*  _nav;                          ///< orbits and clocks
+		t_gpoleut1* _erp;                          ///< poleut1 data
+		shared_ptr<t_gtrs2crs_table> _trs2crs_table;   ///< precomputed TRS2CRS rotations
+		double      _max_dt;                       ///< max distance [s] from ref
+		t_gtime     _epoch;                        ///< epoch of the states
+		map<string, t_gsatstate_item> _states;     ///< states of sats
+	};
+}
+
+#endif // !GSATSTATE_H
@@ -0,0 +1,226 @@
+/**
+ * @file         gldlt.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        blocked LDLT factorization of NEQ in place
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gproc/gldlt.h"
+#include <algorithm>
+
+namespace great
+{
+	t_gldlt::t_gldlt(int block_size) :
+		_block_size(max(block_size, 1)),
+		_data(nullptr),
+		_num(0),
+		_ld(0)
+	{
+	}
+
+	t_gldlt::~t_gldlt()
+	{
+	}
+
+	bool t_gldlt::factorize(C_SymmetricMatrix& NEQ)
+	{
+		if (NEQ.num() == 0)
+		{
+			_data = nullptr; _num = 0; _ld = 0;
+			return true;
+		}
+		return factorize(NEQ.row(0), NEQ.num(), NEQ.ld());
+	}
+
+	bool t_gldlt::factorize(double* data, int num, int ld)
+	{
+		_data = data;
+		_num = num;
+		_ld = ld;
+
+		// right looking: factorize the diagonal block, solve the panel below it
+		// and update the trailing lower triangle
+		for (int k = 0; k < _num; k += _block_size)
+		{
+			int kb = min(_block_size, _num - k);
+			if (!_factorize_diag(k, kb))
+			{
+				return false;
+			}
+
+			int rest = _num - k - kb;
+			if (rest == 0)
+			{
+				break;
+			}
+
+			// A21 * L11^-T = L21 * D1
+			t_eigenmap L11 = _map(k, kb, k, kb);
+			t_eigenmap A21 = _map(k + kb, rest, k, kb);
+			L11.transpose().triangularView<Eigen::UnitUpper>().solveInPlace<Eigen::OnTheRight>(A21);
+
+			Eigen::MatrixXd LD = A21;
+			Eigen::VectorXd d_inv(kb);
+			for (int j = 0; j < kb; j++)
+			{
+				d_inv(j) = 1.0 / _data[(size_t)(k + j) * _ld + k + j];
+			}
+			A21 = A21 * d_inv.asDiagonal();
+
+			// A22 -= L21 * D1 * L21t, only the lower triangle, row panel by row panel
+			int num_panel = (rest + _block_size - 1) / _block_size;
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int ip = 0; ip < num_panel; ip++)
+			{
+				int r = ip * _block_size;
+				int rb = min(_block_size, rest - r);
+				if (r > 0)
+				{
+					_map(k + kb + r, rb, k + kb, r).noalias() -= A21.middleRows(r, rb) * LD.topRows(r).transpose();
+				}
+				Eigen::MatrixXd T = A21.middleRows(r, rb) * LD.middleRows(r, rb).transpose();
+				_map(k + kb + r, rb, k + kb + r, rb).triangularView<Eigen::Lower>() -= T;
+			}
+		}
+
+		return true;
+	}
+
+	void t_gldlt::solve(double* b) const
+	{
+		if (_num == 0) return;
+
+		Eigen::Map<Eigen::VectorXd> x(b, _num);
+		t_eigenmap L = _map(0, _num, 0, _num);
+
+		L.triangularView<Eigen::UnitLower>().solveInPlace(x);
+		for (int i = 0; i < _num; i++)
+		{
+			x(i) /= _data[(size_t)i * _ld + i];
+		}
+		L.transpose().triangularView<Eigen::UnitUpper>().solveInPlace(x);
+	}
+
+	void t_gldlt::inverse_diag(vector<double>& diag) const
+	{
+		diag.assign(_num, 0.0);
+
+		vector<double> d_inv(_num);
+		for (int i = 0; i < _num; i++)
+		{
+			d_inv[i] = 1.0 / _data[(size_t)i * _ld + i];
+		}
+
+		// Q = L^-t * D^-1 * L^-1, Q(i,i) = sum_k L^-1(k,i)^2 / d_k
+		int num_block = (_num + _block_size - 1) / _block_size;
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int ib = 0; ib < num_block; ib++)
+		{
+			int beg = ib * _block_size;
+			int size = min(_block_size, _num - beg);
+
+			Eigen::MatrixXd X;
+			_inverse_L(beg, size, X);
+			for (int c = 0; c < size; c++)
+			{
+				double q = 0.0;
+				for (int r = c; r < X.rows(); r++)
+				{
+					q += X(r, c) * X(r, c) * d_inv[beg + r];
+				}
+				diag[beg + c] = q;
+			}
+		}
+	}
+
+	void t_gldlt::inverse_block(int beg, int size, Eigen::MatrixXd& Q) const
+	{
+		assert(beg >= 0 && size >= 0 && beg + size <= _num);
+
+		vector<int> idx(size);
+		for (int i = 0; i < size; i++)
+		{
+			idx[i] = beg + i;
+		}
+		inverse_selected(idx, Q);
+	}
+
+	void t_gldlt::inverse_selected(const vector<int>& idx, Eigen::MatrixXd& Q) const
+	{
+		if (idx.empty())
+		{
+			Q.resize(0, 0);
+			return;
+		}
+		assert(idx.front() >= 0 && idx.back() < _num);
+
+		// X = L[beg:,beg:]^-1 * E, E holds the unit columns of idx
+		int beg = idx.front();
+		Eigen::MatrixXd X = Eigen::MatrixXd::Zero(_num - beg, idx.size());
+		for (unsigned int c = 0; c < idx.size(); c++)
+		{
+			X(idx[c] - beg, c) = 1.0;
+		}
+		_map(beg, _num - beg, beg, _num - beg).triangularView<Eigen::UnitLower>().solveInPlace(X);
+
+		Eigen::VectorXd d_inv(X.rows());
+		for (int r = 0; r < X.rows(); r++)
+		{
+			d_inv(r) = 1.0 / _data[(size_t)(beg + r) * _ld + beg + r];
+		}
+		Eigen::MatrixXd DX = d_inv.asDiagonal() * X;
+		Q.noalias() = X.transpose() * DX;
+	}
+
+	bool t_gldlt::_factorize_diag(int beg, int size)
+	{
+		// row oriented, w(m) = L(i,m) * d_m of the current row
+		vector<double> w(size);
+		for (int i = 0; i < size; i++)
+		{
+			double* row_i = _data + (size_t)(beg + i) * _ld + beg;
+			for (int j = 0; j < i; j++)
+			{
+				const double* row_j = _data + (size_t)(beg + j) * _ld + beg;
+				double sum = row_i[j];
+				for (int m = 0; m < j; m++)
+				{
+					sum -= w[m] * row_j[m];
+				}
+				w[j] = sum;
+				row_i[j] = sum / row_j[j];
+			}
+
+			double d = row_i[i];
+			for (int m = 0; m < i; m++)
+			{
+				d -= w[m] * row_i[m];
+			}
+			if (!(d > 0.0))
+			{
+				return false;
+			}
+			row_i[i] = d;
+		}
+		return true;
+	}
+
+	t_gldlt::t_eigenmap t_gldlt::_map(int row_beg, int rows, int col_beg, int cols) const
+	{
+		return t_eigenmap(_data + (size_t)row_beg * _ld + col_beg, rows, cols, Eigen::OuterStride<>(_ld));
+	}
+
+	void t_gldlt::_inverse_L(int beg, int size, Eigen::MatrixXd& X) const
+	{
+		X = Eigen::MatrixXd::Zero(_num - beg, size);
+		X.topRows(size).setIdentity();
+		_map(beg, _num - beg, beg, _num - beg).triangularView<Eigen::UnitLower>().solveInPlace(X);
+	}
+}
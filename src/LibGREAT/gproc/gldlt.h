@@ -0,0 +1,95 @@
+/**
+ * @file         gldlt.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        blocked LDLT factorization of NEQ in place
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GLDLT_H
+#define GLDLT_H
+
+#include "gexport/ExportLibGREAT.h"
+#include "gproc/glsqmatrix.h"
+#include "Eigen/Dense"
+#include <vector>
+
+using namespace std;
+
+namespace great
+{
+	/**
+	* @brief  blocked LDLT (without pivoting) of a symmetric positive definite matrix
+	* @note the factor overwrites the lower triangle of the input (row major, leading dimension ld):
+	*       D on the diagonal and the strict lower part of the unit lower L below it.
+	*       The input memory must outlive the factor, nothing is copied.
+	*/
+	class LibGREAT_LIBRARY_EXPORT t_gldlt
+	{
+	public:
+		/** @brief row major matrix map with leading dimension */
+		typedef Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>, 0, Eigen::OuterStride<> > t_eigenmap;
+
+		/**
+		* @brief constructor
+		* @param[in] block_size size of the diagonal blocks
+		*/
+		explicit t_gldlt(int block_size = 64);
+
+		/** @brief default destructor */
+		~t_gldlt();
+
+		/**
+		* @brief factorize the lower triangle in place
+		* @return false if a pivot is not positive
+		*/
+		bool factorize(double* data, int num, int ld);
+
+		/** @brief factorize the NEQ in place */
+		bool factorize(C_SymmetricMatrix& NEQ);
+
+		/** @brief number of rows of the factor */
+		int num() const { return _num; }
+
+		/** @brief solve L*D*Lt*x = b, b is overwritten by x */
+		void solve(double* b) const;
+
+		/**
+		* @brief diagonal of the inverse, column blocks of L^-1 are formed by triangular solves
+		*        and never stored as a whole
+		*/
+		void inverse_diag(vector<double>& diag) const;
+
+		/**
+		* @brief the diagonal block [beg, beg+size) of the inverse
+		* @note beg from 0
+		*/
+		void inverse_block(int beg, int size, Eigen::MatrixXd& Q) const;
+
+		/**
+		* @brief the block of the inverse for the selected rows/cols
+		* @note idx from 0, ascending. Only L[idx[0]:, idx[0]:] is used, so pars
+		*       ordered late in NEQ are cheap
+		*/
+		void inverse_selected(const vector<int>& idx, Eigen::MatrixXd& Q) const;
+
+	private:
+		/** @brief unblocked LDLT of the diagonal block [beg, beg+size) */
+		bool _factorize_diag(int beg, int size);
+
+		/** @brief map of the block of the factor */
+		t_eigenmap _map(int row_beg, int rows, int col_beg, int cols) const;
+
+		/** @brief X = L[beg:,beg:]^-1 * [I 0]t, X is (num-beg) * size */
+		void _inverse_L(int beg, int size, Eigen::MatrixXd& X) const;
+
+		int _block_size;    ///< size of the diagonal blocks
+		double* _data;      ///< factor (not owned)
+		int _num;           ///< rows of the factor
+		int _ld;            ///< leading dimension
+	};
+}
+
+#endif // !GLDLT_H
@@ -50,6 +50,15 @@ namespace great
 			_interval = dynamic_cast<t_gsetgen*>(set)->sampling();
 			_mode = dynamic_cast<t_gsetproc*>(set)->lsq_mode() ;
 			_buffer_size = dynamic_cast<t_gsetproc*>(set)->lsq_buffer_size() * 1024 * 1000;
+
+			t_gsetlsq* set_lsq = dynamic_cast<t_gsetlsq*>(set);
+			if (set_lsq)
+			{
+				_solver = set_lsq->solver();
+				_ldlt_block = set_lsq->ldlt_block();
+				_selected_inverse = set_lsq->selected_inverse();
+				_temp_buffers = set_lsq->temp_buffers();
+			}
 		}
 
 		// get random_tempfile
@@ -70,8 +79,10 @@ namespace great
 				_tempfile->close();
 			}
 			remove(_tempfile->name().c_str());
+			string index_name = _tempfile->index_name();
 			delete _tempfile;
 			_tempfile = nullptr;
+			if (!index_name.empty()) remove(index_name.c_str());
 		}
 
 	}
@@ -97,7 +108,14 @@ namespace great
 		_vtpv(Other._vtpv), _sigma0(Other._sigma0), _obs_total_num(Other._obs_total_num),
 		_obs_total_num_epo(Other._obs_total_num_epo),
 		_solve_matrix(Other._solve_matrix),
-		_buffer_size(Other._buffer_size)
+		_buffer_size(Other._buffer_size),
+		_solver(Other._solver),
+		_ldlt_block(Other._ldlt_block),
+		_selected_inverse(Other._selected_inverse),
+		_temp_buffers(Other._temp_buffers),
+		_Qx_diag(Other._Qx_diag),
+		_Qx_sel_idx(Other._Qx_sel_idx),
+		_Qx_sel(Other._Qx_sel)
 	{
 		stringstream this_addr;
 		this_addr << this;
@@ -129,6 +147,17 @@ namespace great
 		_solve_matrix = solve_matrix;
 	}
 
+	void t_glsq::set_solver(LSQSOLVER solver, int block_size)
+	{
+		_solver = solver;
+		_ldlt_block = block_size;
+	}
+
+	void t_glsq::set_selected_inverse(bool selected_inverse)
+	{
+		_selected_inverse = selected_inverse;
+	}
+
 	bool t_glsq::update_parameter(const t_gtime & epoch, vector<t_gsatdata>& obsdata, bool matrix_remove, bool write_temp)
 	{
 		if (!_update_lsqpar)
@@ -262,18 +291,54 @@ namespace great
 	}
 	int t_glsq::add_equation(const t_glsqEquationMatrix& equ, const t_gtime& epoch,bool write_temp)
 	{
-		if (write_temp) 
+		t_glsqNEQBlock block;
+		block.form(equ);
+		return add_equation(block, equ, epoch, write_temp);
+	}
+
+	int t_glsq::add_equation(const t_glsqNEQBlock& block, const t_glsqEquationMatrix& equ, const t_gtime& epoch, bool write_temp)
+	{
+		if (write_temp)
 		{
 			this->write_equation(equ, epoch);
 		}
 
 		_epo = epoch;
 
-		_NEQ.add(equ);
-		_W.add(equ);
+		_NEQ.add(block);
+		_W.add(block);
 
-		_obs_total_num += equ.num_equ();
-		_res_obs       += equ.res_equ();
+		_obs_total_num += block.num_equ();
+		_res_obs       += block.res_equ();
+
+		return 1;
+	}
+
+	int t_glsq::add_equation(const vector<const t_glsqNEQBlock*>& blocks, const vector<const t_glsqEquationMatrix*>& equs, const t_gtime& epoch, bool write_temp)
+	{
+		if (blocks.size() != equs.size())
+		{
+			if (_log) _log->comment(1, "t_glsq::add_equation", "size of blocks and equations is different!");
+			throw exception();
+		}
+
+		if (write_temp)
+		{
+			for (const auto& equ : equs)
+			{
+				this->write_equation(*equ, epoch);
+			}
+		}
+
+		_epo = epoch;
+
+		_NEQ.add(blocks);
+		for (const auto& block : blocks)
+		{
+			_W.add(*block);
+			_obs_total_num += block->num_equ();
+			_res_obs       += block->res_equ();
+		}
 
 		return 1;
 	}
@@ -310,38 +375,31 @@ namespace great
 	
 	bool  t_glsq::write_equation(const t_glsqEquationMatrix& equ, const t_gtime& epoch)
 	{
+		if (_marginalize) return true;
+
 		if (_tempfile == nullptr)
 		{
 			if (_log) _log->comment(1, "t_glsq::write_equation", "the tempfile don't exist!");
 			throw exception();
 		}
 
-		int len_size = 0;
 
 		// write coefficinet Matrix
 		for (int Row = 1; Row <= equ.num_equ(); Row++)
 		{
-
-			// length of record
-			len_size = 0;
-
 			// write identifier
-			_tempfile->write("obs", 3);
-			len_size += 3;
+			_tempfile->record_begin("obs");
 
 			// write parameter number
 			int par_num = equ.B[Row - 1].size();
 			_tempfile->write((char*)&par_num, SIZE_INT);
-			len_size += SIZE_INT;
 
 			// write time
 			_tempfile->write((char*)&epoch, sizeof(t_gtime));
-			len_size += sizeof(t_gtime);
 
 			// write ambflag
 			int is_newamb = equ.is_newamb(Row - 1) ? 1 : 0;
 			_tempfile->write((char*)&is_newamb, SIZE_INT);
-			len_size += SIZE_INT;
 
 			// write info
 			string out_info;
@@ -350,9 +408,7 @@ namespace great
 				+ equ.get_obscombtype2str(Row - 1) + "     ";
 			int len_out_info = out_info.size();
 			_tempfile->write((char*)&len_out_info, SIZE_INT);
-			len_size += SIZE_INT;
 			_tempfile->write(out_info.c_str(),len_out_info);
-			len_size += len_out_info;
 
 			// write coefficient
 			for (int Col = 1; Col <= par_num; Col++) {
@@ -360,28 +416,23 @@ namespace great
 				int loc = equ.B[Row - 1][Col - 1].first;
 
 				_tempfile->write((char*)&loc, SIZE_INT);
-				len_size += SIZE_INT;
 				_tempfile->write((char*)&coeff, SIZE_DBL);
-				len_size += SIZE_DBL;
 
 			}
 
 			// Write Max loc 
 			int Max_loc = _x_solve.parNumber();
 			_tempfile->write((char*)&Max_loc, SIZE_INT);
-			len_size += SIZE_INT;
 
 			// write P
 			double p = equ.P[Row - 1];
 			_tempfile->write((char*)&p, SIZE_DBL);
-			len_size += SIZE_DBL;
 
 			// write res
 			double res = equ.l[Row - 1];
 			_tempfile->write((char*)&res, SIZE_DBL);
-			len_size += SIZE_DBL;
 
-			_tempfile->write((char*)&len_size, SIZE_INT);
+			_tempfile->record_end();
 		}
 
 		return true;
@@ -398,91 +449,65 @@ namespace great
 		// add apriori
 		add_apriori_weight();
 
-		SymmetricMatrix NEQ_Matrix = _NEQ.changeNewMat();
 		ColumnVector W_Matrix = _W.changeNewMat();
 
-		if (double_eq(NEQ_Matrix.maximum_absolute_value(), 0.0))
+		if (_solver == LSQSOLVER::LDLT || _selected_inverse)
 		{
-			_dx.ReSize(_x_solve.parNumber()); _dx = 0.0;
-			throw NPDException(Matrix(0.0,0,0));
+			// factorize in place, _NEQ is not used after the final solve
+			_solve_LDLT(_NEQ, true, _dx);
 		}
 		else
 		{
-			vector<int> zero_idx;
+			// pars with zero diagonal are not solved, gather the others without copying NEQ
+			int num = _NEQ.num();
+			vector<int> valid_idx, zero_idx;
+			_split_zero_diag(_NEQ, valid_idx, zero_idx);
 
-			for (int Row = 1; Row <= NEQ_Matrix.Nrows(); Row++)
+			if (valid_idx.empty())
 			{
-				if (double_eq(NEQ_Matrix(Row, Row), 0.0))
-				{
-					zero_idx.push_back(Row);
-				}
+				_dx.ReSize(_x_solve.parNumber()); _dx = 0.0;
+				throw NPDException(Matrix(0.0,0,0));
 			}
 
-			if (zero_idx.size() == 0)
+			if (zero_idx.empty())
 			{
-				_solve_equation(NEQ_Matrix, W_Matrix, _dx, _stdx);
+				_solve_equation(_NEQ.changeNewMat(), W_Matrix, _dx, _stdx);
 			}
 			else
 			{
-
-				V_SymmetricMatrix remove_NEQ = _NEQ;
-				V_ColumnVector remove_W = _W;
 				ColumnVector temp_dx, temp_dq;
-				for (auto iter = zero_idx.rbegin(); iter != zero_idx.rend(); iter++) {
-					remove_NEQ.remove(*iter);
-					remove_W.remove(*iter);
-				}
+				_solve_equation(_NEQ.changeNewMat(valid_idx), _W.changeNewMat(valid_idx), temp_dx, temp_dq);
 
-				SymmetricMatrix temp_NEQ = remove_NEQ.changeNewMat();
-				ColumnVector temp_W = remove_W.changeNewMat();
-				_solve_equation(temp_NEQ, temp_W, temp_dx, temp_dq);
-
-				_dx.ReSize(NEQ_Matrix.Nrows()); _dx = 0.0;
-				_stdx.ReSize(NEQ_Matrix.Nrows()); _stdx = 0.0;
-				SymmetricMatrix temp_Qx = _Qx;
-				_Qx.resize(NEQ_Matrix.Nrows()); _Qx = 0.0;
-
-				int idx = 1;
-				int idy = 1;
-				for (int Row = 1; Row <= NEQ_Matrix.Nrows(); Row++) {
-					// not zero
-					if (find(zero_idx.begin(), zero_idx.end(), Row) == zero_idx.end()) {
-						idy = 1;
-						for (int Col = 1; Col <= NEQ_Matrix.Ncols(); Col++)
-						{
-							// not zero
-							if (find(zero_idx.begin(), zero_idx.end(), Col) == zero_idx.end()) {
-								_Qx(Row, Col) = temp_Qx(idx, idy);
-								//cout << setw(12) << setprecision(8) << temp_Qx(idx, idy);
-								idy++;
-							}
-						}
-						_dx(Row) = temp_dx(idx);
-						_stdx(Row) = temp_dq(idx);
-						idx++;
-						//cout << endl;
+				_dx.ReSize(num); _dx = 0.0;
+				_stdx.ReSize(num); _stdx = 0.0;
+				SymmetricMatrix temp_Qx;
+				temp_Qx.swap(_Qx);
+				_Qx.resize(num); _Qx = 0.0;
+
+				for (unsigned int idx = 0; idx < valid_idx.size(); idx++)
+				{
+					for (unsigned int idy = 0; idy <= idx; idy++)
+					{
+						_Qx(valid_idx[idx], valid_idx[idy]) = temp_Qx(idx + 1, idy + 1);
 					}
+					_dx(valid_idx[idx]) = temp_dx(idx + 1);
+					_stdx(valid_idx[idx]) = temp_dq(idx + 1);
 				}
-
-				if (idx != temp_dx.Nrows() + 1)
-					throw exception();
-
 			}
+		}
 
+		// slove sigama0
+		_vtpv = _res_obs;
+		for (int i = 1; i <= _dx.Nrows(); i++) {
+			_vtpv -= W_Matrix(i) * (_dx(i));
+		}
+		_sigma0 = sqrt(abs(_vtpv) / (_obs_total_num - _npar_tot_num));
+		cout << " sigma0 = " << abs(_sigma0) << " ntot = " << _obs_total_num << " npar = " << _npar_tot_num << endl;
 
-			// slove sigama0
-			_vtpv = _res_obs;
-			for (int i = 1; i <= _dx.Nrows(); i++) {
-				_vtpv -= W_Matrix(i) * (_dx(i));
-			}
-			_sigma0 = sqrt(abs(_vtpv) / (_obs_total_num - _npar_tot_num));
-			cout << " sigma0 = " << abs(_sigma0) << " ntot = " << _obs_total_num << " npar = " << _npar_tot_num << endl;
-
-			if (_obs_total_num - _npar_tot_num < 0) _sigma0 = -1.0;
+		if (_obs_total_num - _npar_tot_num < 0) _sigma0 = -1.0;
 
-			for (int i = 1; i <= _stdx.Nrows(); i++) {
-				_stdx(i) = sqrt(_stdx(i)) * _sigma0;
-			}
+		for (int i = 1; i <= _stdx.Nrows(); i++) {
+			_stdx(i) = sqrt(_stdx(i)) * _sigma0;
 		}
 
 		_dx_final << _dx;
@@ -523,61 +548,42 @@ namespace great
 		// add apriori
 		add_apriori_weight();
 
-		SymmetricMatrix NEQ_Matrix = _NEQ.changeNewMat();
 		ColumnVector W_Matrix = _W.changeNewMat();
 
-		if (double_eq(NEQ_Matrix.maximum_absolute_value(), 0.0))
+		if (_solver == LSQSOLVER::LDLT)
 		{
-			_dx.ReSize(_x_solve.parNumber()); _dx = 0.0;
-			throw NPDException(Matrix(0.0, 0, 0));
+			// keep _NEQ, the factor is formed in a contiguous copy
+			C_SymmetricMatrix factor_NEQ = _NEQ;
+			_solve_LDLT(factor_NEQ, false, _dx);
 		}
 		else
 		{
-			vector<int> zero_idx;
+			// pars with zero diagonal are not solved, gather the others without copying NEQ
+			int num = _NEQ.num();
+			vector<int> valid_idx, zero_idx;
+			_split_zero_diag(_NEQ, valid_idx, zero_idx);
 
-			for (int Row = 1; Row <= NEQ_Matrix.Nrows(); Row++)
+			if (valid_idx.empty())
 			{
-				if (double_eq(NEQ_Matrix(Row, Row), 0.0))
-				{
-					zero_idx.push_back(Row);
-				}
+				_dx.ReSize(_x_solve.parNumber()); _dx = 0.0;
+				throw NPDException(Matrix(0.0, 0, 0));
 			}
 
-			if (zero_idx.size() == 0)
+			if (zero_idx.empty())
 			{
-				_solve_x(NEQ_Matrix, W_Matrix, _dx);
+				_solve_x(_NEQ.changeNewMat(), W_Matrix, _dx);
 			}
 			else
 			{
+				ColumnVector temp_dx;
+				_solve_x(_NEQ.changeNewMat(valid_idx), _W.changeNewMat(valid_idx), temp_dx);
 
-				V_SymmetricMatrix remove_NEQ = _NEQ;
-				V_ColumnVector remove_W = _W;
-				ColumnVector temp_dx, temp_dq;
-				for (auto iter = zero_idx.rbegin(); iter != zero_idx.rend(); iter++) {
-					remove_NEQ.remove(*iter);
-					remove_W.remove(*iter);
-				}
-
-				SymmetricMatrix temp_NEQ = remove_NEQ.changeNewMat();
-				ColumnVector temp_W = remove_W.changeNewMat();
-				_solve_x(temp_NEQ, temp_W, temp_dx);
-
-				_dx.ReSize(NEQ_Matrix.Nrows()); _dx = 0.0;
-
-				int idx = 1;
-				int idy = 1;
-				for (int Row = 1; Row <= NEQ_Matrix.Nrows(); Row++) {
-					// not zero
-					if (find(zero_idx.begin(), zero_idx.end(), Row) == zero_idx.end()) {
-						_dx(Row) = temp_dx(idx);
-						idx++;
-					}
+				_dx.ReSize(num); _dx = 0.0;
+				for (unsigned int idx = 0; idx < valid_idx.size(); idx++)
+				{
+					_dx(valid_idx[idx]) = temp_dx(idx + 1);
 				}
-
-				if (idx != temp_dx.Nrows() + 1)
-					throw exception();
 			}
-
 		}
 
 
@@ -595,6 +601,70 @@ namespace great
 		return;
 	}
 
+	double t_glsq::solve_x_epo(ColumnVector& dx)
+	{
+		if (_NEQ.num() != _W.num() || _x_solve.parNumber() != _NEQ.num())
+		{
+			if (_log) _log->comment(1, "t_glsq::solve_x_epo", "input Matrix NEQ or W is Wrong!");
+			throw runtime_error("t_glsq::solve_x_epo:input Matrix NEQ or W is Wrong!");
+		}
+
+		// NEQ with apriori weight in the work matrix, no reallocation if the size is not grown
+		_NEQ_epo = _NEQ;
+		int num = _NEQ_epo.num();
+		for (int Row = 1; Row <= num; Row++)
+		{
+			double apriori = _x_solve[Row - 1].apriori();
+			if (_NEQ_epo.num(Row, Row) == 0.0) continue;
+			if (apriori == 0.0)                continue;
+			_NEQ_epo.num(Row, Row) += 1 / (apriori * apriori);
+		}
+
+		if (_solver == LSQSOLVER::LDLT)
+		{
+			// the work matrix is overwritten by the factor
+			_solve_LDLT(_NEQ_epo, false, dx);
+		}
+		else
+		{
+			vector<int> valid_idx, zero_idx;
+			_split_zero_diag(_NEQ_epo, valid_idx, zero_idx);
+
+			if (valid_idx.empty())
+			{
+				dx.ReSize(num); dx = 0.0;
+				throw NPDException(Matrix(0.0, 0, 0));
+			}
+
+			if (zero_idx.empty())
+			{
+				_solve_x(_NEQ_epo.changeNewMat(), _W.changeNewMat(), dx);
+			}
+			else
+			{
+				ColumnVector temp_dx;
+				_solve_x(_NEQ_epo.changeNewMat(valid_idx), _W.changeNewMat(valid_idx), temp_dx);
+
+				dx.ReSize(num); dx = 0.0;
+				for (unsigned int idx = 0; idx < valid_idx.size(); idx++)
+				{
+					dx(valid_idx[idx]) = temp_dx(idx + 1);
+				}
+			}
+		}
+
+		// slove sigama0
+		double vtpv = _res_obs;
+		for (int i = 1; i <= dx.Nrows(); i++) {
+			vtpv -= _W.num(i) * dx(i);
+		}
+		double sigma0 = sqrt(abs(vtpv) / (_obs_total_num - _npar_tot_num));
+		cout << " sigma0 = " << abs(sigma0) << " ntot = " << _obs_total_num << " npar = " << _npar_tot_num << endl;
+
+		if (_obs_total_num - _npar_tot_num < 0) sigma0 = -1.0;
+		return sigma0;
+	}
+
 	int t_glsq::remove_parameter(const int& idx, bool write_temp)
 	{
 		add_apriori_weight(idx);
@@ -658,112 +728,42 @@ namespace great
 		}
 
 		beg_t = chrono::high_resolution_clock::now();
-		vector<double> temp_NEQ(rows*rows,0.0);
-
-		for (int i =0;i<rows;i++){
-			memcpy(&temp_NEQ[i*rows],&_NEQ._element[i][0],sizeof(double)*(i+1));
-		}
-
-		vector<double> temp_Eigen_NEQ(rows*rows,0.0);
-		for (int i =0;i<rows;i++){
-			for (int j=0;j<=i;j++){
-				temp_Eigen_NEQ[i*rows+j] = _NEQ._element[i][j];
-				temp_Eigen_NEQ[j*rows+i] = _NEQ._element[i][j];
-			}
-		}
-
-		Eigen::VectorXd W1(Eigen::Map<Eigen::VectorXd> (&_W._element[0],rows_new));
-		Eigen::VectorXd W2(Eigen::Map<Eigen::VectorXd> (&_W._element[rows_new],rows_remove));
-
-		Eigen:: MatrixXd A(Eigen::Map<Eigen::MatrixXd, 0, Eigen::OuterStride<> >(&temp_Eigen_NEQ[0],rows_new,rows_new,Eigen::OuterStride<>(rows)));
-		Eigen:: MatrixXd B(Eigen::Map<Eigen::MatrixXd, 0, Eigen::OuterStride<> > (&temp_Eigen_NEQ[rows_new],rows_remove,rows_new,Eigen::OuterStride<>(rows)));
-		Eigen:: MatrixXd C(Eigen::Map<Eigen::MatrixXd, 0, Eigen::OuterStride<> > (&temp_Eigen_NEQ[rows_new*rows+rows_new],rows_remove,rows_remove,Eigen::OuterStride<>(rows)));
-		
+		// eliminate the independent blocks of the removed parameters
+		vector<vector<pair<int, double> > > CiB;
+		vector<double> CiW2;
+		int num_block = _eliminate_block(rows_new, rows_remove, CiB, CiW2);
 		end_t = chrono::high_resolution_clock::now();
-		cout << "Init Matrix time is " << chrono::duration_cast<chrono::milliseconds>(end_t-beg_t).count() / 1000.0 << " sec " << endl;
-
-		Eigen::MatrixXd CL,CLi,Ci,Bt,CiB,CiW2,NEQ_new,W_new;
-		vector<double> CiB_vec(rows_remove*rows_new,0.0);
-		vector<double> CiW2_vec(rows_remove,0.0);
-		if (rows_remove!=0){
-			beg_t = chrono::high_resolution_clock::now();
-			//Colosky 
-			CL = Eigen::LLT<Eigen::MatrixXd>(C).matrixL();
-			CLi.noalias() = CL.inverse();
-			Ci.noalias() = CLi.transpose() * CLi;
-			
-			end_t = chrono::high_resolution_clock::now();
-			cout << "Eigen Cholosky Spend time is " << chrono::duration_cast<chrono::milliseconds>(end_t-beg_t).count() / 1000.0 << " sec " << endl;
-
-			beg_t = chrono::high_resolution_clock::now();
-			// transpose
-			Bt.noalias() = B.transpose();
-			
-			// multiply
-			CiB.noalias() = Ci * B;
-			CiW2.noalias() = Ci * W2;
-
-			// multiply decmial  
-			NEQ_new.noalias() = A-Bt*CiB;
-			W_new.noalias() = W1 - Bt*CiW2;
-
-
-			//get new res_obs
-			_res_obs = _res_obs - (W2.transpose()*CiW2)(0,0);
-
-			// ouptut matrix
-			for (int i = 0; i < rows_new; i++)
-			{
-				for (int j = 0; j <= i; j++)
-				{
-					_NEQ._element[i][j] = NEQ_new(i, j);
-				}
-				_W._element[i] = W_new(i);
-			}
-			end_t = chrono::high_resolution_clock::now();
-			cout << "Eigen Multiply and Resize Matrix Spend time is " << chrono::duration_cast<chrono::milliseconds>(end_t-beg_t).count() / 1000.0 << " sec " << endl;
-		}
+		cout << "Eliminate " << num_block << " blocks Spend time is " << chrono::duration_cast<chrono::milliseconds>(end_t-beg_t).count() / 1000.0 << " sec " << endl;
 
 		// Resize
+		vector<int> idx_resize;
 		for (int i = rows - 1; i >= rows_new; i--)
 		{
-			_NEQ.remove(i + 1);
-			_W.remove(i + 1);
+			idx_resize.push_back(i + 1);
 		}
+		_NEQ.remove(idx_resize);
+		_W._element.resize(rows_new);
 
 		beg_t = chrono::high_resolution_clock::now();
 		// _write_coefficient
-		if (_tempfile) 
+		if (_tempfile && !_marginalize) 
 		{
 			for (int i = rows_remove-1; i>=0; i--)
 			{
-				int len_size = 0;
 				// write identifier
-				_tempfile->write("prt", 3);
-				len_size += 3;
+				_tempfile->record_begin("prt");
 
 				// write parameter number
-				vector<pair<int, double> > par_record;
-				double w_record;
-
-				w_record = CiW2(i);
-				for (int j = 0; j < rows_new; j++)
-				{
-					if (CiB(i, j)!=0.0)
-					{
-						par_record.push_back(make_pair(j+1, CiB(i, j)));
-					}
-				}
+				const vector<pair<int, double> >& par_record = CiB[i];
+				double w_record = CiW2[i];
 
 				// write par num
 				int par_num = par_record.size();
 				_tempfile->write((char*)&par_num, SIZE_INT);
-				len_size += SIZE_INT;
 
 				// write parameter index
 				int par_idx = rows_new+i+1;
 				_tempfile->write((char*)&(par_idx), SIZE_INT);
-				len_size += SIZE_INT;
 				par_idx--;
 
 				// write par name station satlltie
@@ -771,40 +771,32 @@ namespace great
 				name = _x_solve[par_idx].site + "_" + name;
 				if (_x_solve[par_idx].prn == "" && _x_solve[par_idx].parType != par_type::GLO_IFB) name = name + "_";
 				_tempfile->write(name.c_str(), 20);
-				len_size += 20;
 
 
 				// write par time
 				_tempfile->write((char*)&_x_solve[par_idx].beg, sizeof(t_gtime));
-				len_size += sizeof(t_gtime);
 				_tempfile->write((char*)&_x_solve[par_idx].end, sizeof(t_gtime));
-				len_size += sizeof(t_gtime);
 
 
 				// write parameter value
 				double value = _x_solve[par_idx].value();
 				_tempfile->write((char*)&value, SIZE_DBL);
-				len_size += SIZE_DBL;
 
 				// write zhd for ztd retrieval
 				double zhd = _x_solve[par_idx].zhd;
 				_tempfile->write((char*)&zhd, SIZE_DBL);
-				len_size += SIZE_DBL;
 
 				// write coefficient BTPB
 				for (int ipar = 1; ipar <= par_num; ipar++)
 				{
 					_tempfile->write((char*)&(par_record[ipar - 1].first), SIZE_INT);
-					len_size += SIZE_INT;
 					_tempfile->write((char*)&(par_record[ipar - 1].second), SIZE_DBL);
-					len_size += SIZE_DBL;
 				}
 
 				// write BTPL
 				_tempfile->write((char*)&w_record, SIZE_DBL);
-				len_size += SIZE_DBL;
 
-				_tempfile->write((char*)&len_size, SIZE_INT);
+				_tempfile->record_end();
 
 				// remove par
 				_x_solve.delParam(par_idx);
@@ -824,6 +816,125 @@ namespace great
 
 		return 1;
 	}
+	int t_glsq::_eliminate_block(int rows_new, int rows_remove, vector<vector<pair<int, double> > >& CiB, vector<double>& CiW2)
+	{
+		CiB.assign(rows_remove, vector<pair<int, double> >());
+		CiW2.assign(rows_remove, 0.0);
+		if (rows_remove == 0) return 0;
+
+		// group the removed parameters coupled in C, e.g. the ambiguities of
+		// one site are not coupled with each other and each forms its own block
+		vector<int> root(rows_remove);
+		for (int i = 0; i < rows_remove; i++) root[i] = i;
+		auto find_root = [&root](int i)
+		{
+			while (root[i] != i)
+			{
+				root[i] = root[root[i]];
+				i = root[i];
+			}
+			return i;
+		};
+		for (int i = 0; i < rows_remove; i++)
+		{
+			const double* row = _NEQ.row(rows_new + i) + rows_new;
+			for (int j = 0; j < i; j++)
+			{
+				if (row[j] == 0.0) continue;
+				int ri = find_root(i), rj = find_root(j);
+				if (ri != rj) root[max(ri, rj)] = min(ri, rj);
+			}
+		}
+		map<int, vector<int> > blocks;
+		for (int i = 0; i < rows_remove; i++)
+		{
+			blocks[find_root(i)].push_back(i);
+		}
+
+		// | A  Bt |
+		// | B  C  |  for each block only the columns of A coupled with B are updated
+		vector<char> coupled(rows_new, 0);
+		for (const auto& block : blocks)
+		{
+			const vector<int>& rem = block.second;
+			int nc = rem.size();
+
+			// columns of A coupled with the block
+			vector<int> col;
+			for (int a = 0; a < nc; a++)
+			{
+				const double* row = _NEQ.row(rows_new + rem[a]);
+				for (int j = 0; j < rows_new; j++)
+				{
+					if (row[j] != 0.0 && !coupled[j])
+					{
+						coupled[j] = 1;
+						col.push_back(j);
+					}
+				}
+			}
+			sort(col.begin(), col.end());
+			int ns = col.size();
+
+			Eigen::MatrixXd C(nc, nc);
+			Eigen::MatrixXd B(nc, ns);
+			Eigen::VectorXd W2(nc);
+			for (int a = 0; a < nc; a++)
+			{
+				const double* row = _NEQ.row(rows_new + rem[a]);
+				for (int b = 0; b <= a; b++)
+				{
+					C(a, b) = C(b, a) = row[rows_new + rem[b]];
+				}
+				for (int k = 0; k < ns; k++)
+				{
+					B(a, k) = row[col[k]];
+				}
+				W2(a) = _W._element[rows_new + rem[a]];
+			}
+
+			// G = L^-1 * B, then Ci*B = L^-T * G and Bt*Ci*B = Gt*G
+			Eigen::LLT<Eigen::MatrixXd> llt(C);
+			Eigen::MatrixXd G = llt.matrixL().solve(B);
+			Eigen::MatrixXd CiB_block = llt.matrixU().solve(G);
+			Eigen::VectorXd CiW2_block = llt.solve(W2);
+
+			//get new res_obs
+			_res_obs -= W2.dot(CiW2_block);
+
+			if (ns > 0)
+			{
+				Eigen::MatrixXd GtG = Eigen::MatrixXd::Zero(ns, ns);
+				GtG.selfadjointView<Eigen::Lower>().rankUpdate(G.transpose());
+				Eigen::VectorXd BtCiW2 = B.transpose() * CiW2_block;
+				for (int k = 0; k < ns; k++)
+				{
+					double* row = _NEQ.row(col[k]);
+					for (int l = 0; l <= k; l++)
+					{
+						row[col[l]] -= GtG(k, l);
+					}
+					_W._element[col[k]] -= BtCiW2(k);
+					coupled[col[k]] = 0;
+				}
+			}
+
+			for (int a = 0; a < nc; a++)
+			{
+				for (int k = 0; k < ns; k++)
+				{
+					if (CiB_block(a, k) != 0.0)
+					{
+						CiB[rem[a]].push_back(make_pair(col[k] + 1, CiB_block(a, k)));
+					}
+				}
+				CiW2[rem[a]] = CiW2_block(a);
+			}
+		}
+
+		return blocks.size();
+	}
+
 	bool t_glsq::recover_parameters(t_gallrecover& allrecover)
 	{
 		gtrace("_glsq::recover_parameters");
@@ -838,33 +949,39 @@ namespace great
 			return false;
 		}
 
-		_tempfile->flush();
-		_tempfile->close();
-
-		t_greadtemp tempfile_in(_tempfile->mask());
-
-		int len_size = size_int;
-		tempfile_in.seekg_from_cur(-len_size);
-		tempfile_in.read((char*)&len_size, size_int);
-
-		// loop for tempfile
-		while (len_size != -1) 
+		if (_tempfile->finalize() < 0)
 		{
-			len_size += size_int;
-			//_tempfile->seekg(-len_size, ios::cur);
-			tempfile_in.seekg_from_cur(-len_size);
+			if (_log) _log->comment(0, " t_glsq::recover_parameters", "finalize tempfile Wrong!");
+			return false;
+		}
+		if (_log)
+		{
+			_log->comment(2, "t_glsq::recover_parameters", "tempfile " + int2str((int)(_tempfile->bytes_written() / 1024)) + " KB "
+				+ int2str((int)_tempfile->num_record()) + " records, writer stalled " + dbl2str(_tempfile->stall_time(), 3) + " s");
+		}
 
-			char identifiy[3];
-			//_tempfile->read(identifiy, 3);
-			tempfile_in.read(identifiy, 3);
+		t_gmaptemp tempfile_map(_tempfile->name(), _tempfile->index_name());
 
-			string temp(identifiy, 3);
+		// loop for records from the last one
+		for (int64_t irec = tempfile_map.num_record() - 1; irec >= 0; irec--)
+		{
+			string temp(tempfile_map.type(irec), 3);
 
 			if (temp == "obs") 
 			{
-				_recover_obs(tempfile_in,allrecover);
+				// obs between two par records only read dx, recover them together
+				int64_t ibeg = irec;
+				while (ibeg > 0 && strncmp(tempfile_map.type(ibeg - 1), "obs", 3) == 0)
+				{
+					ibeg--;
+				}
+				_recover_obs(tempfile_map, ibeg, irec, allrecover);
+				irec = ibeg;
+				continue;
 			}
-			else if (temp == "par") 
+
+			t_gtemprecord tempfile_in = tempfile_map.record(irec);
+			if (temp == "par") 
 			{
 				_recover_par(tempfile_in,allrecover);
 			}
@@ -878,15 +995,6 @@ namespace great
 			else {
 				break;
 			}
-
-			// back 
-			len_size -= size_int;
-			tempfile_in.seekg_from_cur(-len_size);
-
-			// read length
-			len_size = size_int;
-			tempfile_in.seekg_from_cur(-len_size);
-			tempfile_in.read((char*)&len_size, size_int);
 		}
 
 		allrecover.set_interval(_interval);
@@ -1056,7 +1164,7 @@ namespace great
 	}
 	V_SymmetricMatrix t_glsq::v_NEQ() const
 	{
-		return _NEQ;
+		return _NEQ.changeVMat();
 	}
 
 	V_ColumnVector t_glsq::v_W() const
@@ -1073,6 +1181,18 @@ namespace great
 	}
 	double t_glsq::Qx(const int& col, const int& row) const
 	{
+		if (_Qx.Nrows() == 0 && !_Qx_diag.empty())
+		{
+			if (col == row) return _Qx_diag[col - 1];
+
+			auto iter_col = _Qx_sel_idx.find(col);
+			auto iter_row = _Qx_sel_idx.find(row);
+			if (iter_col == _Qx_sel_idx.end() || iter_row == _Qx_sel_idx.end())
+			{
+				throw logic_error("t_glsq::Qx: element is not in the selected inverse");
+			}
+			return _Qx_sel(iter_col->second, iter_row->second);
+		}
 		return _Qx(col, row);
 	}
 	double t_glsq::dx(int idx) const
@@ -1115,22 +1235,26 @@ namespace great
 				_tempfile->close();
 			}
 			remove(_tempfile->name().c_str());
+			string index_name = _tempfile->index_name();
 			delete _tempfile;
+			if (!index_name.empty()) remove(index_name.c_str());
 		}
 
-		_tempfile = new t_giobigf(filename,_buffer_size);
+		_tempfile = new t_giotemp(filename,_buffer_size);
 		_tempfile->tsys(t_gtime::GPS);
 		_tempfile->mask(filename);
 		_tempfile->append(false);
-		_tempfile->open(filename, ios::out | ios::trunc | ios::binary);
-
-		// for begin
-		int identify = -1;
-		_tempfile->write((char*)&identify, SIZE_INT);
+		_tempfile->open_temp(filename);
+		if (_temp_buffers >= 2 && _tempfile->start_async(_temp_buffers) < 0)
+		{
+			if (_log) _log->comment(1, "t_glsq::reset_tempfile", "start async tempfile writing Wrong!");
+		}
 	}
 
 	int t_glsq::_write_parchage(const vector<int>& remove_id)
 	{
+		if (_marginalize) return 0;
+
 		if (!_tempfile)
 		{
 			if (_log)
@@ -1141,28 +1265,25 @@ namespace great
 
 		}
 
-		int len_size = 0;
-		_tempfile->write("swp", 3);
-		len_size += 3;
+		_tempfile->record_begin("swp");
 
 		int total_size = _x_solve.parNumber();
 		_tempfile->write((char*)&total_size, sizeof(int));
-		len_size += sizeof(int);
 		
 		int remove_size = remove_id.size();
 		_tempfile->write((char*)&remove_size, sizeof(int));
-		len_size += sizeof(int);
 
 		for (int i = 0; i < remove_size; i++) {
 			_tempfile->write((char*)&remove_id[i], sizeof(int));
-			len_size += sizeof(int);
 		}
 
-		_tempfile->write((char*)&len_size, sizeof(int));
+		_tempfile->record_end();
 		return 0;
 	}
 	int t_glsq::_write_coefficient(int idx)
 	{
+		if (_marginalize) return 0;
+
 		ostringstream os;
 		if (idx < 1 || idx > _NEQ.num()) 
 		{
@@ -1181,10 +1302,8 @@ namespace great
 			return -1;
 
 		}
-		int len_size = 0;
 		// write identifier
-		_tempfile->write("par", 3);
-		len_size += 3;
+		_tempfile->record_begin("par");
 
 		// write parameter number
 		vector<pair<int, double> > par_record;
@@ -1203,55 +1322,45 @@ namespace great
 		// write par num
 		int par_num = par_record.size();
 		_tempfile->write((char*)&par_num, SIZE_INT);
-		len_size += SIZE_INT;
 
 		// write parameter index
 		_tempfile->write((char*)&idx, SIZE_INT);
-		len_size += SIZE_INT;
 
 		// write par name station satlltie
 		const t_gpar& par_tmp = _x_solve[idx - 1];
 		string name = par_tmp.site + "_" + par_tmp.str_type();
 		if (par_tmp.prn == "" && par_tmp.parType != par_type::GLO_IFB) name = name + "_";
 		_tempfile->write(name.c_str(), 20);
-		len_size += 20;
 
 
 		// write par time
 		_tempfile->write((char*)&par_tmp.beg, sizeof(t_gtime));
-		len_size += sizeof(t_gtime);
 		_tempfile->write((char*)&par_tmp.end, sizeof(t_gtime));
-		len_size += sizeof(t_gtime);
 
 
 		// write parameter value
 		double value = par_tmp.value();
 		_tempfile->write((char*)&value, SIZE_DBL);
-		len_size += SIZE_DBL;
 
 		double zhd = par_tmp.zhd;
 		_tempfile->write((char*)&zhd, SIZE_DBL);
-		len_size += SIZE_DBL;
 
 		// write coefficient BTPB
 		for (int ipar = 1; ipar <= par_num; ipar++)
 		{
 			_tempfile->write((char*)&(par_record[ipar - 1].first), SIZE_INT);
-			len_size += SIZE_INT;
 			_tempfile->write((char*)&(par_record[ipar - 1].second), SIZE_DBL);
-			len_size += SIZE_DBL;
 		}
 
 		// write BTPL
 		_tempfile->write((char*)&w_record, SIZE_DBL);
-		len_size += SIZE_DBL;
 
-		_tempfile->write((char*)&len_size, SIZE_INT);
+		_tempfile->record_end();
 
 		return 1;
 	}
 
-	void t_glsq::_recover_par(t_greadtemp& tempfile_in,t_gallrecover& _allrecover)
+	void t_glsq::_recover_par(t_gtemprecord& tempfile_in,t_gallrecover& _allrecover)
 	{
 
 		// read par number
@@ -1358,7 +1467,7 @@ namespace great
 		_allrecover.add_recover_par(recover_par);
 
 	}
-	void t_glsq::_recover_par_part(t_greadtemp & tempfile_in, t_gallrecover & _allrecover)
+	void t_glsq::_recover_par_part(t_gtemprecord& tempfile_in, t_gallrecover & _allrecover)
 	{
 		// read par number
 		int par_num;
@@ -1437,7 +1546,7 @@ namespace great
 		t_grecover_par recover_par(par, _dx(idx));
 		_allrecover.add_recover_par(recover_par);
 	}
-	void t_glsq::_recover_par_swap(t_greadtemp & tempfile_in)
+	void t_glsq::_recover_par_swap(t_gtemprecord& tempfile_in)
 	{
 		// read total size
 		int total_size = 0;
@@ -1473,7 +1582,51 @@ namespace great
 		}
 
 	}
-	void t_glsq::_recover_obs(t_greadtemp& tempfile_in,t_gallrecover& _allrecover)
+	void t_glsq::_recover_obs(const t_gmaptemp& tempfile_map, int64_t beg, int64_t end, t_gallrecover& _allrecover)
+	{
+		int64_t num = end - beg + 1;
+		vector<t_grecover_equation*> recover_equs(num, nullptr);
+		vector<int> max_loc(num, 0);
+		vector<char> valid(num, 1);
+
+		// the records are decoded from the last one as the serial loop does
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic, 256) if (num > 1024)
+#endif
+		for (int64_t i = 0; i < num; i++)
+		{
+			try
+			{
+				t_gtemprecord tempfile_in = tempfile_map.record(end - i);
+				recover_equs[i] = _recover_obs(tempfile_in, _dx, max_loc[i]);
+			}
+			catch (...)
+			{
+				valid[i] = 0;
+			}
+		}
+
+		if (find(valid.begin(), valid.end(), 0) != valid.end())
+		{
+			for (auto equ : recover_equs) delete equ;
+			if (_log) {
+				_log->comment(1, "t_glsq::_recover_obs", "par recover more than par now Recover Fail!");
+			}
+			throw exception();
+		}
+
+		// pars added after the obs are not used any more
+		int min_loc = *min_element(max_loc.begin(), max_loc.end());
+		if (_dx.Nrows() > min_loc) {
+			ColumnVector _dx_temp = _dx;
+			_dx.ReSize(min_loc);
+			_dx << _dx_temp.Rows(1, min_loc);
+		}
+
+		_allrecover.add_recover_equation(recover_equs);
+	}
+
+	t_grecover_equation* t_glsq::_recover_obs(t_gtemprecord& tempfile_in, const ColumnVector& dx, int& Max_loc) const
 	{
 		// read parnumber
 		int par_num;
@@ -1490,37 +1643,24 @@ namespace great
 		// read info
 		int len_info;
 		tempfile_in.read((char*)&len_info, SIZE_INT);
-		char* info = new char[len_info];
-		tempfile_in.read(info, len_info);
+		string info(tempfile_in.data(), len_info);
+		tempfile_in.skip(len_info);
 
 
 		// B for recording the coefficient of obs equation
-		if (par_num > _dx.Nrows()) {
-			if (_log) {
-				_log->comment(1, "t_glsq::_recover_obs", "par recover more than par now Recover Fail!");
-			}
+		if (par_num > dx.Nrows()) {
 			throw exception();
 		}
 
-		//shared_ptr<double> B(new double[par_num]);
-		vector<int> loc;
-		vector<double> B;
+		vector<int> loc(par_num);
+		vector<double> B(par_num);
 
-		for (int ipar = 1; ipar <= par_num; ipar++) {
-			int i; double j;
-			tempfile_in.read((char*)&i, SIZE_INT);
-			loc.push_back(i);
-			tempfile_in.read((char*)&j, SIZE_DBL);
-			B.push_back(j);
+		for (int ipar = 0; ipar < par_num; ipar++) {
+			tempfile_in.read((char*)&loc[ipar], SIZE_INT);
+			tempfile_in.read((char*)&B[ipar], SIZE_DBL);
 		}
 
-		int Max_loc;
 		tempfile_in.read((char*)&Max_loc, SIZE_INT);
-		if (_dx.Nrows() > Max_loc) {
-			ColumnVector _dx_temp = _dx;
-			_dx.ReSize(Max_loc);
-			_dx << _dx_temp.Rows(1, Max_loc);
-		}
 
 		// read p
 		double p;
@@ -1532,16 +1672,15 @@ namespace great
 
 		// compute the new res
 		for (int ipar = 0; ipar < par_num; ipar++) {
-			res -= B[ipar] * _dx(loc[ipar]);
+			res -= B[ipar] * dx(loc[ipar]);
 		}
 
-		stringstream obsinfo(string(info,len_info));
-		delete[] info; info = nullptr;
+		stringstream obsinfo(info);
 		string site, sat, str_obstype ;
 		obsinfo >> site >> sat >> str_obstype;
-		t_grecover_equation recover_equ(time, site, sat);
-		recover_equ.set_recover_equation(t_gobscombtype(str_obstype), make_pair(p, res),is_newamb);
-		_allrecover.add_recover_equation(recover_equ);
+		t_grecover_equation* recover_equ = new t_grecover_equation(time, site, sat);
+		recover_equ->set_recover_equation(t_gobscombtype(str_obstype), make_pair(p, res),is_newamb);
+		return recover_equ;
 
 	}
 	void t_glsq::_remove_zero_element(SymmetricMatrix& B, ColumnVector& l, int idx)
@@ -1603,6 +1742,84 @@ namespace great
 
 		ans << x;
 	}
+	void t_glsq::_split_zero_diag(const C_SymmetricMatrix& NEQ, vector<int>& valid_idx, vector<int>& zero_idx) const
+	{
+		valid_idx.clear();
+		zero_idx.clear();
+		for (int i = 1; i <= NEQ.num(); i++)
+		{
+			if (double_eq(NEQ.num(i, i), 0.0)) zero_idx.push_back(i);
+			else valid_idx.push_back(i);
+		}
+	}
+
+	void t_glsq::_solve_LDLT(C_SymmetricMatrix& NEQ, bool inverse, ColumnVector& dx)
+	{
+		int num = NEQ.num();
+
+		// pars with zero diagonal are not solved
+		vector<int> valid_idx, zero_idx;
+		_split_zero_diag(NEQ, valid_idx, zero_idx);
+
+		if (valid_idx.empty())
+		{
+			dx.ReSize(_x_solve.parNumber()); dx = 0.0;
+			throw NPDException(Matrix(0.0, 0, 0));
+		}
+		NEQ.remove(zero_idx);
+
+		t_gldlt ldlt(_ldlt_block);
+		if (!ldlt.factorize(NEQ))
+		{
+			if (_log) _log->comment(1, "t_glsq::_solve_LDLT", "NEQ is not positive definite!");
+			throw NPDException(Matrix(0.0, 0, 0));
+		}
+
+		vector<double> x(valid_idx.size());
+		for (unsigned int i = 0; i < valid_idx.size(); i++)
+		{
+			x[i] = _W.num(valid_idx[i]);
+		}
+		ldlt.solve(x.data());
+
+		dx.ReSize(num); dx = 0.0;
+		for (unsigned int i = 0; i < valid_idx.size(); i++)
+		{
+			dx(valid_idx[i]) = x[i];
+		}
+
+		if (inverse)
+		{
+			vector<double> diag;
+			ldlt.inverse_diag(diag);
+
+			// only the diagonal of Qx is formed
+			_Qx.ReSize(0);
+			_Qx_diag.assign(num, 0.0);
+			_stdx.ReSize(num); _stdx = 0.0;
+			for (unsigned int i = 0; i < valid_idx.size(); i++)
+			{
+				_Qx_diag[valid_idx[i] - 1] = diag[i];
+				_stdx(valid_idx[i]) = diag[i];
+			}
+
+			// and the satellite clock block
+			_Qx_sel_idx.clear();
+			_Qx_sel.resize(0, 0);
+			if (_selected_inverse)
+			{
+				vector<int> sel_idx;
+				for (unsigned int i = 0; i < valid_idx.size(); i++)
+				{
+					if (_x_solve[valid_idx[i] - 1].parType != par_type::CLK_SAT) continue;
+					_Qx_sel_idx[valid_idx[i]] = sel_idx.size();
+					sel_idx.push_back(i);
+				}
+				ldlt.inverse_selected(sel_idx, _Qx_sel);
+			}
+		}
+	}
+
 	void t_glsq::change_NEQ(int row, int col, double xx)
 	{
 		_NEQ.num(row, col) = xx;
@@ -1660,7 +1877,7 @@ namespace great
 	void t_glsq::set_new_NEQ(const V_ColumnVector& W, const V_SymmetricMatrix& NEQ)
 	{
 		_W = W;
-		_NEQ = NEQ;
+		_NEQ = C_SymmetricMatrix(NEQ);
 	}
 
 
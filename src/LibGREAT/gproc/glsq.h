@@ -27,6 +27,8 @@
 #include "gall/gallrecover.h"
 #include "gproc/gupdatepar.h"
 #include "gproc/ginverse.h"
+#include "gproc/gldlt.h"
+#include "gset/gsetlsq.h"
 #include <thread>
 
 using namespace std;
@@ -71,6 +73,22 @@ namespace great
 
 		void set_solve_matrix(shared_ptr<t_ginverse<Matrix> > solve_matrix);
 
+		/**
+		* @brief set the solver of NEQ
+		* @note LDLT factorizes _NEQ in place in solve_NEQ and only the diagonal of Qx (stdx) is computed
+		*/
+		void set_solver(LSQSOLVER solver, int block_size = 64);
+
+		/** @brief only compute the diagonal and the satellite clock block of Qx in solve_NEQ */
+		void set_selected_inverse(bool selected_inverse);
+
+		/**
+		* @brief marginalize the removed parameters into NEQ only
+		* @note nothing is written to the tempfile (equations, eliminated parameters), so the
+		*       parameters can not be recovered. Used by the sliding window with bounded storage.
+		*/
+		void set_marginalize(bool marginalize) { _marginalize = marginalize; }
+
 		/**
 		* @brief update all lsq par with now obs data
 		* @note according to obsdata update amb par , and time update outsate par
@@ -108,6 +126,25 @@ namespace great
 		*/
 		int add_equation(const t_glsqEquationMatrix& equ, const t_gtime& epoch = t_gtime(),bool write_temp=true);
 
+		/**
+		* @brief add new observ equations with their local NEQ block formed before
+		* @note  block.form(equ) can be done outside of the lock, only the scatter is done here
+		* @param[in] block local BTPB/BTPL of equ
+		* @param[in] equ equations info (for tempfile)
+		* @param[in] epoch time of equations
+		*/
+		int add_equation(const t_glsqNEQBlock& block, const t_glsqEquationMatrix& equ, const t_gtime& epoch = t_gtime(), bool write_temp = true);
+
+		/**
+		* @brief add the equations of several groups (e.g. all sites of one epoch) at once
+		* @note  the NEQ is reduced in parallel by rows in the order of blocks (bit-reproducible
+		*        for any number of threads), tempfile is written in the same order
+		* @param[in] blocks local BTPB/BTPL of each group
+		* @param[in] equs equations of each group (for tempfile)
+		* @param[in] epoch time of equations
+		*/
+		int add_equation(const vector<const t_glsqNEQBlock*>& blocks, const vector<const t_glsqEquationMatrix*>& equs, const t_gtime& epoch = t_gtime(), bool write_temp = true);
+
 		int get_equ_obs_total_num();
 
 		/** @brief del old observ equations[lsqmatrix format]
@@ -150,6 +187,15 @@ namespace great
 		*/
 		virtual void solve_x();
 
+		/**
+		* @brief solve the current NEQ for the epoch-wise solution without copying the lsq
+		* @note NEQ, W and the results of the lsq are not changed, the apriori weighted NEQ
+		*       is formed (and factorized) in a work matrix whose storage is kept between epochs
+		* @param[out] dx correction of all parameter, 0 for pars with zero diagonal
+		* @return sigma0 of the epoch solution
+		*/
+		double solve_x_epo(ColumnVector& dx);
+
 		/**
 		* @brief recover the removed par by information in tempfile 
 		* @note recover should after solving equations and have temp file
@@ -212,6 +258,11 @@ namespace great
 		/** @brief get covariance of coerrection of parametes */
 		ColumnVector	stdx() const;
 
+		/**
+		* @brief get the element of covariance matrix
+		* @note with the LDLT solver only the diagonal is available, and the
+		*       satellite clock block in selected inverse mode
+		*/
 		double Qx(const int& col, const int& row) const;
 
 		/** @brief get coerrection of specified parametes */
@@ -286,14 +337,32 @@ namespace great
 		// remove_id from 1;
 		int _write_parchage(const vector<int>& remove_id);
 
+		/**
+		* @brief  eliminate the last rows_remove parameters of NEQ block by block
+		* @note the removed parameters are grouped into blocks coupled in NEQ,
+		*       each block only updates the rows/cols it is coupled with.
+		*       CiB/CiW2 return C^-1*B (col from 1) and C^-1*W2 of each removed par
+		* @return number of eliminated blocks
+		*/
+		int _eliminate_block(int rows_new, int rows_remove, vector<vector<pair<int, double> > >& CiB, vector<double>& CiW2);
+
 
 		/** @brief recover parameter */
-		void _recover_par(t_greadtemp& tempfile_in, t_gallrecover& _allrecover);
-		void _recover_par_part(t_greadtemp& tempfile_in, t_gallrecover& _allrecover);
-		void _recover_par_swap(t_greadtemp& tempfile_in);
+		void _recover_par(t_gtemprecord& tempfile_in, t_gallrecover& _allrecover);
+		void _recover_par_part(t_gtemprecord& tempfile_in, t_gallrecover& _allrecover);
+		void _recover_par_swap(t_gtemprecord& tempfile_in);
+
+		/**
+		* @brief recover the obs records [beg, end] in parallel, dx is only read
+		* @note the equations are added to allrecover from the last record as before
+		*/
+		void _recover_obs(const t_gmaptemp& tempfile_map, int64_t beg, int64_t end, t_gallrecover& _allrecover);
 
-		/** @brief recover obs */
-		void _recover_obs(t_greadtemp& tempfile_in, t_gallrecover& _allrecover);
+		/**
+		* @brief recover one obs with dx
+		* @param[out] Max_loc number of pars when the obs was written
+		*/
+		t_grecover_equation* _recover_obs(t_gtemprecord& tempfile_in, const ColumnVector& dx, int& Max_loc) const;
 
 
 		/** @brief remove zero element in NEQ matrix */
@@ -303,11 +372,23 @@ namespace great
 		void _solve_equation(const SymmetricMatrix& NEQ, const ColumnVector& W, ColumnVector& ans, ColumnVector& Q);
 		void _solve_x(const SymmetricMatrix& NEQ, const ColumnVector& W, ColumnVector& ans);
 
+		/**
+		* @brief solve equation with blocked LDLT, NEQ is overwritten by the factor
+		* @note pars with zero diagonal are skipped, their dx and stdx are zero
+		* @param[in] inverse compute the diagonal of the inverse into _stdx
+		* @param[out] dx solution
+		*/
+		void _solve_LDLT(C_SymmetricMatrix& NEQ, bool inverse, ColumnVector& dx);
+
+		/** @brief split the pars (from 1) by zero diagonal of NEQ */
+		void _split_zero_diag(const C_SymmetricMatrix& NEQ, vector<int>& valid_idx, vector<int>& zero_idx) const;
+
 
 		t_glog*	_log;						///< log file
 
 		V_ColumnVector    _W;				///< BTPL Matrix
-		V_SymmetricMatrix _NEQ;			    ///< BTPB Matrix
+		C_SymmetricMatrix _NEQ;			    ///< BTPB Matrix (contiguous storage)
+		C_SymmetricMatrix _NEQ_epo;		    ///< work matrix of solve_x_epo, storage reused between epochs
 
 		SymmetricMatrix _Qx;					///< storage Qx after solve
 		ColumnVector	_dx;					///< correction of all parameter
@@ -325,13 +406,21 @@ namespace great
 		t_gtime	_beg;						///< begin time
 		t_gtime	_end;						///< end time
 		double  _interval;                     ///< intv
-		t_giobigf*	_tempfile;					///< temp file
+		t_giotemp*	_tempfile;					///< temp file (indexed records)
 		LSQMODE  _mode;						///< lsq model
 		int _buffer_size=1024*1000*10; 		///< tempfile buffer size
 
 		
 		shared_ptr<t_gupdatepar> _update_lsqpar;
 		shared_ptr<t_ginverse<Matrix> > _solve_matrix;
+		LSQSOLVER _solver = LSQSOLVER::CHOLESKY;	///< solver of NEQ
+		int _ldlt_block = 64;						///< size of diagonal blocks in LDLT
+		bool _selected_inverse = false;				///< only diagonal and satellite clock block of Qx
+		bool _marginalize = false;					///< removed pars only marginalized, no tempfile records
+		int _temp_buffers = 0;						///< tempfile buffers written in background (<2: no thread)
+		vector<double> _Qx_diag;					///< diagonal of Qx when _Qx is not formed
+		map<int, int> _Qx_sel_idx;					///< par idx (from 1) -> row of _Qx_sel
+		Eigen::MatrixXd _Qx_sel;					///< selected block of Qx
 
 		t_gmutex _lsq_mtx;
 
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <emmintrin.h>
 #include <assert.h>
+#include <cstring>
 
 namespace great
 {
@@ -397,6 +398,132 @@ namespace great
 		_newamb_list.clear();
 	}
 
+	t_glsqNEQBlock::t_glsqNEQBlock()
+	{
+	}
+
+	t_glsqNEQBlock::~t_glsqNEQBlock()
+	{
+	}
+
+	void t_glsqNEQBlock::clear()
+	{
+		_index.clear();
+		_loc.clear();
+		_N.clear();
+		_W.clear();
+		_num_equ = 0;
+		_ltpl = 0.0;
+	}
+
+	void t_glsqNEQBlock::form(const t_glsqEquationMatrix& equ, bool phase)
+	{
+		this->clear();
+
+		// union of the pars touched by the equations
+		int num_coeff = 0;
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			if (phase && equ.get_obscombtype(num).is_code()) continue;
+			for (const auto& coeff : equ.B[num])
+			{
+				_index.push_back(coeff.first);
+			}
+			num_coeff += equ.B[num].size();
+			_num_equ++;
+			_ltpl += equ.P[num] * equ.l[num] * equ.l[num];
+		}
+		sort(_index.begin(), _index.end());
+		_index.erase(unique(_index.begin(), _index.end()), _index.end());
+
+		int k = _index.size();
+		_N.assign((size_t)k * k, 0.0);
+		_W.assign(k, 0.0);
+		if (k == 0) return;
+
+		// local idx of every coeff, the local order is the same as the global one
+		_loc.reserve(num_coeff);
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			if (phase && equ.get_obscombtype(num).is_code()) continue;
+			for (const auto& coeff : equ.B[num])
+			{
+				_loc.push_back(lower_bound(_index.begin(), _index.end(), coeff.first) - _index.begin());
+			}
+		}
+
+		// dense kernel only pays off when each equation touches a large part of the block
+		if (num_coeff > 0.25 * k * _num_equ && k >= 16)
+		{
+			_form_dense(equ, phase);
+		}
+		else
+		{
+			_form_sparse(equ, phase);
+		}
+	}
+
+	void t_glsqNEQBlock::_form_sparse(const t_glsqEquationMatrix& equ, bool phase)
+	{
+		const int k = _index.size();
+		int iloc = 0;
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			if (phase && equ.get_obscombtype(num).is_code()) continue;
+			const auto& B = equ.B[num];
+			const double P = equ.P[num];
+			const double Pl = P * equ.l[num];
+			const int* loc = &_loc[iloc];
+			for (int ipar = 0; ipar < B.size(); ipar++)
+			{
+				double* N_row = &_N[(size_t)loc[ipar] * k];
+				const double PB = B[ipar].second * P;
+				for (int jpar = 0; jpar < B.size(); jpar++)
+				{
+					if (loc[jpar] > loc[ipar]) continue;
+					N_row[loc[jpar]] += PB * B[jpar].second;
+				}
+				_W[loc[ipar]] += B[ipar].second * Pl;
+			}
+			iloc += B.size();
+		}
+	}
+
+	void t_glsqNEQBlock::_form_dense(const t_glsqEquationMatrix& equ, bool phase)
+	{
+		const int k = _index.size();
+
+		// sqrt(P) weighted coeff, negative weight (virtual equations) go to a separate down-date
+		Eigen::MatrixXd B_pos = Eigen::MatrixXd::Zero(_num_equ, k);
+		Eigen::MatrixXd B_neg;
+		int num_pos = 0, num_neg = 0;
+		int iloc = 0;
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			if (phase && equ.get_obscombtype(num).is_code()) continue;
+			const auto& B = equ.B[num];
+			const double P = equ.P[num];
+			const double Pl = P * equ.l[num];
+			const double sqrt_P = sqrt(fabs(P));
+			if (P < 0.0 && B_neg.size() == 0) B_neg = Eigen::MatrixXd::Zero(_num_equ, k);
+			Eigen::MatrixXd& B_w = (P < 0.0) ? B_neg : B_pos;
+			int irow = (P < 0.0) ? num_neg++ : num_pos++;
+			for (int ipar = 0; ipar < B.size(); ipar++)
+			{
+				B_w(irow, _loc[iloc + ipar]) += sqrt_P * B[ipar].second;
+				_W[_loc[iloc + ipar]] += B[ipar].second * Pl;
+			}
+			iloc += B.size();
+		}
+
+		C_SymmetricMatrix::t_eigenmap N(_N.data(), k, k, Eigen::OuterStride<>(k));
+		N.selfadjointView<Eigen::Lower>().rankUpdate(B_pos.topRows(num_pos).transpose(), 1.0);
+		if (num_neg > 0)
+		{
+			N.selfadjointView<Eigen::Lower>().rankUpdate(B_neg.topRows(num_neg).transpose(), -1.0);
+		}
+	}
+
 	L_SymmetricMatrix::L_SymmetricMatrix() :
 		row_record(0),
 		col_record(0)
@@ -911,6 +1038,16 @@ namespace great
 		}
 	}
 
+	void V_ColumnVector::add(const t_glsqNEQBlock& block)
+	{
+		const vector<int>& index = block.index();
+		const vector<double>& W = block.W();
+		for (int i = 0; i < block.num(); i++)
+		{
+			_element[index[i] - 1] += W[i];
+		}
+	}
+
 	void V_ColumnVector::addBackZero()
 	{
 		_element.push_back(0.0);
@@ -942,6 +1079,16 @@ namespace great
 		return temp;
 	}
 
+	ColumnVector V_ColumnVector::changeNewMat(const vector<int>& idx) const
+	{
+		ColumnVector temp(idx.size());
+		for (unsigned int i = 0; i < idx.size(); i++)
+		{
+			temp(i + 1) = _element[idx[i] - 1];
+		}
+		return temp;
+	}
+
 	void V_ColumnVector::swap(int a, int b)
 	{
 		double temp;
@@ -950,6 +1097,340 @@ namespace great
 		_element[b - 1] = temp;
 	}
 
+	C_SymmetricMatrix::C_SymmetricMatrix()
+	{
+	}
+
+	C_SymmetricMatrix::C_SymmetricMatrix(const V_SymmetricMatrix& Other)
+	{
+		this->resize(Other.num());
+		for (int i = 0; i < _num; i++)
+		{
+			memcpy(row(i), &Other._element[i][0], sizeof(double) * (i + 1));
+		}
+	}
+
+	int C_SymmetricMatrix::num() const
+	{
+		return _num;
+	}
+
+	void C_SymmetricMatrix::resize(int num)
+	{
+		_num = num;
+		_ld = num;
+		_element.assign((size_t)num * num, 0.0);
+	}
+
+	void C_SymmetricMatrix::reserve(int capacity)
+	{
+		if (capacity > _ld)
+		{
+			_relayout(capacity);
+		}
+	}
+
+	void C_SymmetricMatrix::add(const t_glsqEquationMatrix& equ)
+	{
+		// cycle equ
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			// cycle par, lower triangle need the sorted index
+			_B_sort.assign(equ.B[num].begin(), equ.B[num].end());
+			sort(_B_sort.begin(), _B_sort.end());
+			const double P = equ.P[num];
+			for (int ipar = 0; ipar < _B_sort.size(); ipar++)
+			{
+				double* NEQ_row = row(_B_sort[ipar].first - 1);
+				const double PB = _B_sort[ipar].second * P;
+				for (int jpar = 0; jpar <= ipar; jpar++)
+				{
+					NEQ_row[_B_sort[jpar].first - 1] += PB * _B_sort[jpar].second;
+				}
+			}
+		}
+	}
+
+	void C_SymmetricMatrix::del(const t_glsqEquationMatrix& equ)
+	{
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			_B_sort.assign(equ.B[num].begin(), equ.B[num].end());
+			sort(_B_sort.begin(), _B_sort.end());
+			const double P = equ.P[num];
+			for (int ipar = 0; ipar < _B_sort.size(); ipar++)
+			{
+				double* NEQ_row = row(_B_sort[ipar].first - 1);
+				const double PB = _B_sort[ipar].second * P;
+				for (int jpar = 0; jpar <= ipar; jpar++)
+				{
+					NEQ_row[_B_sort[jpar].first - 1] -= PB * _B_sort[jpar].second;
+				}
+			}
+		}
+	}
+
+	void C_SymmetricMatrix::add(const t_glsqEquationMatrix& equ, bool phase)
+	{
+		if (!phase)
+		{
+			this->add(equ);
+			return;
+		}
+		for (int num = 0; num < equ.num_equ(); num++)
+		{
+			if (equ.get_obscombtype(num).is_code()) {
+				continue;
+			}
+			_B_sort.assign(equ.B[num].begin(), equ.B[num].end());
+			sort(_B_sort.begin(), _B_sort.end());
+			const double P = equ.P[num];
+			for (int ipar = 0; ipar < _B_sort.size(); ipar++)
+			{
+				double* NEQ_row = row(_B_sort[ipar].first - 1);
+				const double PB = _B_sort[ipar].second * P;
+				for (int jpar = 0; jpar <= ipar; jpar++)
+				{
+					NEQ_row[_B_sort[jpar].first - 1] += PB * _B_sort[jpar].second;
+				}
+			}
+		}
+	}
+
+	void C_SymmetricMatrix::add(const t_glsqNEQBlock& block)
+	{
+		const int k = block.num();
+		const vector<int>& index = block.index();
+		const vector<double>& N = block.N();
+		for (int i = 0; i < k; i++)
+		{
+			double* NEQ_row = row(index[i] - 1);
+			const double* N_row = &N[(size_t)i * k];
+			for (int j = 0; j <= i; j++)
+			{
+				NEQ_row[index[j] - 1] += N_row[j];
+			}
+		}
+	}
+
+	void C_SymmetricMatrix::add(const vector<const t_glsqNEQBlock*>& blocks)
+	{
+		if (blocks.empty() || _num == 0) return;
+
+		// split the rows so that each chunk has about the same area of lower triangle
+		const int num_chunk = min(_num, 64);
+		vector<int> chunk_beg(num_chunk + 1, _num);
+		for (int ichunk = 0; ichunk < num_chunk; ichunk++)
+		{
+			chunk_beg[ichunk] = (int)(_num * sqrt((double)ichunk / num_chunk));
+		}
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int ichunk = 0; ichunk < num_chunk; ichunk++)
+		{
+			const int row_beg = chunk_beg[ichunk];
+			const int row_end = chunk_beg[ichunk + 1];
+			for (const auto& block : blocks)
+			{
+				const int k = block->num();
+				const vector<int>& index = block->index();
+				const vector<double>& N = block->N();
+				// index is ascending and from 1
+				int i = lower_bound(index.begin(), index.end(), row_beg + 1) - index.begin();
+				for (; i < k && index[i] <= row_end; i++)
+				{
+					double* NEQ_row = row(index[i] - 1);
+					const double* N_row = &N[(size_t)i * k];
+					for (int j = 0; j <= i; j++)
+					{
+						NEQ_row[index[j] - 1] += N_row[j];
+					}
+				}
+			}
+		}
+	}
+
+	void C_SymmetricMatrix::addBackZero()
+	{
+		if (_num + 1 > _ld)
+		{
+			// grow by 1/4 to keep relayout amortized but memory close to n*n
+			_relayout(max(_num + 1, _ld + _ld / 4 + 64));
+		}
+		memset(row(_num), 0, sizeof(double) * (_num + 1));
+		_num++;
+	}
+
+	void C_SymmetricMatrix::remove(int idx)
+	{
+		if (idx < 1 || idx > _num) {
+			throw exception(logic_error("C_SymmetricMatrix::remove input idx is out of range"));
+		}
+		vector<bool> is_remove(_num, false);
+		is_remove[idx - 1] = true;
+		_compact(is_remove, idx - 1);
+	}
+
+	void C_SymmetricMatrix::remove(const vector<int>& idx)
+	{
+		if (idx.empty()) {
+			return;
+		}
+		vector<bool> is_remove(_num, false);
+		int first_remove = _num;
+		for (const auto& i : idx)
+		{
+			if (i < 1 || i > _num || is_remove[i - 1]) {
+				throw exception(logic_error("C_SymmetricMatrix::remove input idx is wrong"));
+			}
+			is_remove[i - 1] = true;
+			first_remove = min(first_remove, i - 1);
+		}
+		_compact(is_remove, first_remove);
+	}
+
+	void C_SymmetricMatrix::print()
+	{
+		cout << setw(20) << setprecision(5);
+		for (int i = 0; i < _num; i++)
+		{
+			const double* NEQ_row = row(i);
+			for (int j = 0; j <= i; j++)
+			{
+				cout << setw(20) << NEQ_row[j];
+			}
+			cout << endl;
+		}
+	}
+
+	double C_SymmetricMatrix::center_value(int idx) const
+	{
+		return _element[(size_t)(idx - 1) * _ld + idx - 1];
+	}
+
+	SymmetricMatrix C_SymmetricMatrix::changeNewMat() const
+	{
+		// newmat stores the lower triangle row by row without gap
+		SymmetricMatrix temp(_num);
+		Real* store = temp.data();
+		for (int i = 0; i < _num; i++)
+		{
+			memcpy(store, row(i), sizeof(double) * (i + 1));
+			store += i + 1;
+		}
+		return temp;
+	}
+
+	SymmetricMatrix C_SymmetricMatrix::changeNewMat(const vector<int>& idx) const
+	{
+		int num = idx.size();
+		SymmetricMatrix temp(num);
+		Real* store = temp.data();
+		for (int i = 0; i < num; i++)
+		{
+			const double* NEQ_row = row(idx[i] - 1);
+			for (int j = 0; j <= i; j++)
+			{
+				*store++ = NEQ_row[idx[j] - 1];
+			}
+		}
+		return temp;
+	}
+
+	V_SymmetricMatrix C_SymmetricMatrix::changeVMat() const
+	{
+		V_SymmetricMatrix temp;
+		temp.resize(_num);
+		for (int i = 0; i < _num; i++)
+		{
+			memcpy(&temp._element[i][0], row(i), sizeof(double) * (i + 1));
+		}
+		return temp;
+	}
+
+	void C_SymmetricMatrix::swap(int a, int b)
+	{
+		double temp_a = num(a, a);
+		double temp_b = num(b, b);
+		double temp_ab = num(a, b);
+		for (int i = 0; i < _num; i++)
+		{
+			double temp = num(a, i + 1);
+			num(a, i + 1) = num(b, i + 1);
+			num(b, i + 1) = temp;
+		}
+		num(a, a) = temp_b;
+		num(b, b) = temp_a;
+		num(a, b) = temp_ab;
+	}
+
+	C_SymmetricMatrix::t_eigenmap C_SymmetricMatrix::eigen_map(int beg, int size)
+	{
+		return t_eigenmap(_element.data() + (size_t)beg * _ld + beg, size, size, Eigen::OuterStride<>(_ld));
+	}
+
+	C_SymmetricMatrix::t_eigenmap C_SymmetricMatrix::eigen_map()
+	{
+		return eigen_map(0, _num);
+	}
+
+	C_SymmetricMatrix::t_eigenmap C_SymmetricMatrix::eigen_map(int row_beg, int rows, int col_beg, int cols)
+	{
+		assert(row_beg >= col_beg + cols || rows == 0 || cols == 0);
+		return t_eigenmap(_element.data() + (size_t)row_beg * _ld + col_beg, rows, cols, Eigen::OuterStride<>(_ld));
+	}
+
+	void C_SymmetricMatrix::_relayout(int ld)
+	{
+		if (ld == _ld) {
+			return;
+		}
+		if (ld > _ld)
+		{
+			// grow: move rows from the last one, the new place is always behind the old one
+			_element.resize((size_t)ld * ld, 0.0);
+			for (int i = _num - 1; i > 0; i--)
+			{
+				memmove(&_element[(size_t)i * ld], &_element[(size_t)i * _ld], sizeof(double) * (i + 1));
+			}
+		}
+		else
+		{
+			assert(ld >= _num);
+			for (int i = 1; i < _num; i++)
+			{
+				memmove(&_element[(size_t)i * ld], &_element[(size_t)i * _ld], sizeof(double) * (i + 1));
+			}
+			_element.resize((size_t)ld * ld);
+		}
+		_ld = ld;
+	}
+
+	void C_SymmetricMatrix::_compact(const vector<bool>& is_remove, int first_remove)
+	{
+		// rows before first_remove are not changed.
+		// the destination (new_row,new_col) is never behind the source (row,col), so the copy is in place
+		int new_row = first_remove;
+		for (int i = first_remove + 1; i < _num; i++)
+		{
+			if (is_remove[i]) continue;
+			double* dst = row(new_row);
+			const double* src = row(i);
+			// cols before first_remove keep the position
+			memmove(dst, src, sizeof(double) * first_remove);
+			int new_col = first_remove;
+			for (int j = first_remove; j <= i; j++)
+			{
+				if (is_remove[j]) continue;
+				dst[new_col++] = src[j];
+			}
+			new_row++;
+		}
+		_num = new_row;
+	}
+
 	bool remove_lsqmatrix(int idx, V_SymmetricMatrix& NEQ, V_ColumnVector& W)
 	{
 		if (NEQ.num() != W.num())
@@ -1191,6 +1672,149 @@ namespace great
 		}
 		return zero_idx.size();
 	}
-	
 
-}
\ No newline at end of file
+	bool remove_lsqmatrix(int idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W)
+	{
+		if (NEQ.num() != W.num())
+			return false;
+		if (idx <1 || idx > NEQ.num())
+			return false;
+
+		double center_value = NEQ.center_value(idx);
+
+		if (!double_eq(center_value, 0.0))
+		{
+			int NEQ_num = NEQ.num();
+
+			// record need remove element
+			vector<double>  remove_element(NEQ_num, 0.0);
+			vector<int> remove_rows;
+			for (int col = 1; col <= NEQ_num; col++)
+			{
+				remove_element[col - 1] = NEQ.num(idx, col);
+				if (col == idx || double_eq(remove_element[col - 1], 0.0))
+				{
+					continue;
+				}
+				remove_rows.push_back(col - 1);
+			}
+
+			double w_remove = W._element[idx - 1];
+
+			// remove the par in NEQ and W by for cycle
+			int remove_rows_size = remove_rows.size();
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int i = 0; i < remove_rows_size; ++i)
+			{
+				int row = remove_rows[i];
+				double temp_coeff = -remove_element[row] / center_value;
+				double* NEQ_row = NEQ.row(row);
+				for (int col = 0; col <= row; col++)
+				{
+					NEQ_row[col] += remove_element[col] * temp_coeff;
+				}
+
+				W._element[row] += w_remove * temp_coeff;
+			}
+		}
+
+		NEQ.remove(idx);
+		W.remove(idx);
+
+		return true;
+	}
+
+	int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W, t_gallpar& allpar)
+	{
+		if (remove_idx.size() == 0)
+		{
+			return true;
+		}
+
+		int rows = NEQ.num();
+
+		vector<bool> idx_map(rows, false);
+		set<int> zero_idx;
+		int remove_size = remove_idx.size();
+		for (int i = 0; i < remove_size; i++)
+		{
+			idx_map[remove_idx[i] - 1] = true;
+			if (NEQ.center_value(remove_idx[i]) == 0.0) {
+				zero_idx.insert(remove_idx[i] - 1);
+			}
+		}
+
+		// rearrange paramter and init map_idx
+		t_gallpar allpar_orig = allpar; allpar.delAllParam();
+		vector<int> map_idx(rows);//map from old -> new
+		vector<int> remove_idx_new; // from new->old (size is remove size)
+		// add not remove parameter
+		int count = 0;
+		for (int i = 0; i < rows; i++)
+		{
+			if (idx_map[i])
+			{
+				continue;
+			}
+			allpar.addParam(allpar_orig[i]);
+			map_idx[i] = count++;
+		}
+		// add remove paramter (but center value not zero)
+		for (int i = 0; i < remove_size; i++)
+		{
+			if (zero_idx.count(remove_idx[i] - 1) != 0) {
+				continue;
+			}
+			allpar.addParam(allpar_orig[remove_idx[i] - 1]);
+			map_idx[remove_idx[i] - 1] = count++;
+			remove_idx_new.push_back(remove_idx[i]);
+		}
+		// add remove parameter (but center value is zero)
+		for (auto i : zero_idx) {
+			allpar.addParam(allpar_orig[i]);
+			map_idx[i] = count++;
+			remove_idx_new.push_back(i + 1);
+		}
+
+		assert(rows == count);
+
+		// rearrange remove_idx
+		assert(remove_idx.size() == remove_idx_new.size());
+		remove_idx = remove_idx_new;
+
+		// the kept pars do not change the order, so rows before the first removed one stay in place
+		int first_move = 0;
+		while (first_move < rows && map_idx[first_move] == first_move) first_move++;
+		if (first_move == rows)
+		{
+			return zero_idx.size();
+		}
+
+		// only the moved rows are copied, packed row by row
+		auto packed_beg = [first_move](int i) { return (size_t)i * (i + 1) / 2 - (size_t)first_move * (first_move + 1) / 2; };
+		vector<double> NEQ_orig(packed_beg(rows));
+		for (int i = first_move; i < rows; i++)
+		{
+			memcpy(&NEQ_orig[packed_beg(i)], NEQ.row(i), sizeof(double) * (i + 1));
+		}
+		vector<double> W_orig(W._element.begin(), W._element.end());
+
+		// rearrange
+#ifdef USE_OPENMP
+#pragma	omp parallel for schedule(dynamic)
+#endif
+		for (int i = first_move; i < rows; i++) {
+			int x = map_idx[i];
+			const double* orig_row = &NEQ_orig[packed_beg(i)];
+			for (int j = 0; j <= i; j++) {
+				int y = map_idx[j];
+				(x > y ? NEQ.row(x)[y] : NEQ.row(y)[x]) = orig_row[j];
+			}
+			W._element[x] = W_orig[i];
+		}
+		return zero_idx.size();
+	}
+
+}
@@ -133,6 +133,65 @@ namespace great
 	};
 
 
+	/**
+	* @brief  local normal equation block of a group of observ equations (one site or one epoch)
+	* @note   BTPB and BTPL are accumulated in a small dense block indexed by the union of the pars
+	*         touched by the equations, so the global NEQ is only scattered once per group.
+	*         form() does not touch any global state and can be called in parallel.
+	*/
+	class LibGREAT_LIBRARY_EXPORT t_glsqNEQBlock
+	{
+	public:
+		/** @brief default constructor */
+		t_glsqNEQBlock();
+
+		/** @brief default destructor */
+		~t_glsqNEQBlock();
+
+		/**
+		* @brief form the local BTPB/BTPL block of equations
+		* @note clean the data before
+		* @param[in] equ observ equations
+		* @param[in] phase only phase equations are used
+		*/
+		void form(const t_glsqEquationMatrix& equ, bool phase = false);
+
+		/** @brief clean the block */
+		void clear();
+
+		/** @brief number of local pars */
+		int num() const { return _index.size(); }
+
+		/** @brief global idx (from 1, ascending) of local pars */
+		const vector<int>& index() const { return _index; }
+
+		/** @brief local BTPB, lower triangle row by row with stride num() */
+		const vector<double>& N() const { return _N; }
+
+		/** @brief local BTPL */
+		const vector<double>& W() const { return _W; }
+
+		/** @brief number of equations in the block */
+		int num_equ() const { return _num_equ; }
+
+		/** @brief LTPL of equations in the block */
+		double res_equ() const { return _ltpl; }
+
+	private:
+		/** @brief sparse kernel: outer product of each equation in the local block */
+		void _form_sparse(const t_glsqEquationMatrix& equ, bool phase);
+
+		/** @brief dense kernel: rank-k update with sqrt(P) weighted coeff */
+		void _form_dense(const t_glsqEquationMatrix& equ, bool phase);
+
+		vector<int> _index;        ///< local -> global idx (from 1)
+		vector<int> _loc;          ///< local idx of all coeff (flatten by equation)
+		vector<double> _N;         ///< local BTPB (k*k, lower valid)
+		vector<double> _W;         ///< local BTPL
+		int _num_equ = 0;
+		double _ltpl = 0.0;
+	};
+
 	/**
 	* @brief  Matrix for storage Matrix NEQ
 	*/
@@ -363,6 +422,7 @@ namespace great
 	};
 
 	class LibGREAT_LIBRARY_EXPORT V_SymmetricMatrix;
+	class LibGREAT_LIBRARY_EXPORT C_SymmetricMatrix;
 
 	class LibGREAT_LIBRARY_EXPORT V_ColumnVector :public t_glsqColumnVector
 	{
@@ -374,15 +434,20 @@ namespace great
 		void add(const t_glsqEquationMatrix& equ);
 		void del(const t_glsqEquationMatrix& equ);
 		void add(const t_glsqEquationMatrix& equ, bool phase);
+		void add(const t_glsqNEQBlock& block);
 		void addBackZero();
 		void remove(int idx);
 		void print();
 		ColumnVector changeNewMat();
+		/** @brief gather the elements in idx (from 1, ascending) */
+		ColumnVector changeNewMat(const vector<int>& idx) const;
 		void swap(int a, int b);
 
 		friend bool LibGREAT_LIBRARY_EXPORT remove_lsqmatrix(int idx, V_SymmetricMatrix& NEQ, V_ColumnVector& W);
 		friend bool LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(const vector<int>& remove_idx, t_gallpar& allpar, V_SymmetricMatrix& NEQ, V_ColumnVector& W, Eigen::MatrixXd& N11, Eigen::MatrixXd& N21, Eigen::MatrixXd& N22, Eigen::VectorXd& W1, Eigen::VectorXd& W2, bool idx_from_zero);
 		friend int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, V_SymmetricMatrix & NEQ, V_ColumnVector & W, t_gallpar& allpar);
+		friend bool LibGREAT_LIBRARY_EXPORT remove_lsqmatrix(int idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W);
+		friend int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W, t_gallpar& allpar);
 		friend class t_glsq;
 	private:
 		vector<double> _element;
@@ -411,11 +476,127 @@ namespace great
 		friend bool LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(const vector<int>& remove_idx, t_gallpar& allpar, V_SymmetricMatrix& NEQ, V_ColumnVector& W, Eigen::MatrixXd& N11, Eigen::MatrixXd& N21, Eigen::MatrixXd& N22, Eigen::VectorXd& W1, Eigen::VectorXd& W2, bool idx_from_zero);
 		friend int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, V_SymmetricMatrix & NEQ, V_ColumnVector & W, t_gallpar& allpar);
 		friend class t_glsq;
+		friend class C_SymmetricMatrix;
 
 	private:
 		vector< vector<double> > _element;
 	};
 
+	/**
+	* @brief  contiguous storage of NEQ matrix
+	* @note   lower triangle is stored row by row in one buffer with leading dimension _ld (>= num),
+	*         so the whole matrix (or any diagonal block) can be mapped by Eigen without copy.
+	*         The upper triangle of the buffer is not used.
+	*/
+	class LibGREAT_LIBRARY_EXPORT C_SymmetricMatrix :public t_glsqSymmetricMatrix
+	{
+	public:
+		typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> t_rowmatrix;
+		typedef Eigen::Map<t_rowmatrix, 0, Eigen::OuterStride<> > t_eigenmap;
+
+		/** @brief default constructor */
+		C_SymmetricMatrix();
+
+		/** @brief convert from the vector storage */
+		explicit C_SymmetricMatrix(const V_SymmetricMatrix& Other);
+
+		int num() const;
+		inline double& num(int a, int b) { return (a < b) ? _element[(size_t)(b - 1) * _ld + a - 1] : _element[(size_t)(a - 1) * _ld + b - 1]; }
+		inline double  num(int a, int b) const { return (a < b) ? _element[(size_t)(b - 1) * _ld + a - 1] : _element[(size_t)(a - 1) * _ld + b - 1]; }
+
+		/**
+		* @brief resize the NEQ matrix according to specified size
+		* @note clean the data before
+		*/
+		void resize(int num);
+
+		/**
+		* @brief reserve the leading dimension to avoid relayout when adding pars
+		* @param[in] capacity max dimension expected
+		*/
+		void reserve(int capacity);
+
+		void add(const t_glsqEquationMatrix& equ);
+		void del(const t_glsqEquationMatrix& equ);
+		void add(const t_glsqEquationMatrix& equ, bool phase);
+
+		/**
+		* @brief scatter the local block to NEQ
+		* @param[in] block local BTPB formed before
+		*/
+		void add(const t_glsqNEQBlock& block);
+
+		/**
+		* @brief scatter several local blocks to NEQ
+		* @note rows of NEQ are split between threads, each element is summed in the order of blocks,
+		*       so the result does not depend on the number of threads
+		* @param[in] blocks local BTPB formed before
+		*/
+		void add(const vector<const t_glsqNEQBlock*>& blocks);
+		void addBackZero();
+
+		/**
+		* @brief removed specified dimension in the NEQ matrix
+		* @note idx from 1
+		*/
+		void remove(int idx);
+
+		/**
+		* @brief removed several dimensions in one compaction pass
+		* @note idx from 1
+		* @param[in] idx dimensions to remove (any order, no duplicate)
+		*/
+		void remove(const vector<int>& idx);
+
+		void print();
+		double center_value(int idx) const;
+		SymmetricMatrix changeNewMat() const;
+
+		/**
+		* @brief gather the sub matrix of the dimensions in idx without copying the whole NEQ
+		* @param[in] idx dimensions to keep (from 1, ascending)
+		*/
+		SymmetricMatrix changeNewMat(const vector<int>& idx) const;
+		V_SymmetricMatrix changeVMat() const;
+		void swap(int a, int b);
+
+		/** @brief leading dimension of the storage */
+		int ld() const { return _ld; }
+
+		/** @brief pointer to the first element of row (idx from 0) */
+		inline double* row(int idx) { return &_element[(size_t)idx * _ld]; }
+		inline const double* row(int idx) const { return &_element[(size_t)idx * _ld]; }
+
+		/**
+		* @brief map the block [beg, beg+size) x [beg, beg+size) of NEQ by Eigen without copy
+		* @note idx from 0, only the lower triangle of the map is valid (use selfadjointView<Eigen::Lower>)
+		*/
+		t_eigenmap eigen_map(int beg, int size);
+		t_eigenmap eigen_map();
+
+		/**
+		* @brief map the off-diagonal block rows [row_beg, row_beg+rows) x cols [col_beg, col_beg+cols)
+		* @note idx from 0, must be lay in the lower triangle (row_beg >= col_beg + cols)
+		*/
+		t_eigenmap eigen_map(int row_beg, int rows, int col_beg, int cols);
+
+		friend bool LibGREAT_LIBRARY_EXPORT remove_lsqmatrix(int idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W);
+		friend int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W, t_gallpar& allpar);
+		friend class t_glsq;
+
+	private:
+		/** @brief change the leading dimension and move rows to their new place */
+		void _relayout(int ld);
+
+		/** @brief compact rows/cols keeping the flagged ones, start from first removed row */
+		void _compact(const vector<bool>& is_remove, int first_remove);
+
+		int _num = 0;                   ///< dimension of NEQ
+		int _ld = 0;                    ///< leading dimension (row stride) of storage
+		vector<double> _element;        ///< storage, lower triangle row by row
+		vector<pair<int, double> > _B_sort; ///< reused buffer for sorting the coeff of one equation
+	};
+
 
 
 
@@ -425,6 +606,10 @@ namespace great
 	// by matrix part
 	bool LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(const vector<int>& remove_idx, t_gallpar& allpar, V_SymmetricMatrix& NEQ, V_ColumnVector& W, Eigen::MatrixXd& N11, Eigen::MatrixXd& N21, Eigen::MatrixXd& N22, Eigen::VectorXd& W1, Eigen::VectorXd& W2, bool idx_from_zero = true);
 	int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, V_SymmetricMatrix & NEQ, V_ColumnVector & W,t_gallpar& allpar);
+
+	// for contiguous storage
+	bool LibGREAT_LIBRARY_EXPORT remove_lsqmatrix(int idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W);
+	int LibGREAT_LIBRARY_EXPORT rearrange_lsqmatrix(vector<int>& remove_idx, C_SymmetricMatrix& NEQ, V_ColumnVector& W, t_gallpar& allpar);
 }
 
 
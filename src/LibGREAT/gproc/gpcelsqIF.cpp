@@ -14,6 +14,7 @@
 #include "gset/gsetgen.h"
 #include "gutils/ginfolog.h"
 #include "gproc/gupdateparIF.h"
+#include "gutils/gturboedit.h"
 
 #include "gproc/ginverse_Eigen.h"
 #include <gcoders/recover.h>
@@ -79,6 +80,59 @@ namespace great
 
 		_quality_control->setNav(_gall_nav);
 
+		// arcs of the sites without log files edited from the observations
+		if (_slip12 && !_lite_turboedit && dynamic_cast<t_gsetturboedit*>(_gset)->innerMode() && !_obs_queue)
+		{
+			chrono::high_resolution_clock::time_point beg_edit = chrono::high_resolution_clock::now();
+			int nsite = dynamic_cast<t_gturboedit*>(_slip12.get())->edit(_gall_obs, _rec_list, _beg_time, _end_time, _obs_intv);
+			double edit_sec = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - beg_edit).count() / 1000.0;
+			write_log_info(_glog, 1, "NOTE", "TurboEdit: " + int2str(nsite) + " sites edited in " + dbl2str(edit_sec) + " sec");
+		}
+		else if (_slip12 && !_lite_turboedit && dynamic_cast<t_gsetturboedit*>(_gset)->innerMode())
+		{
+			// the arcs are edited over the whole session, not known for streamed observations
+			write_log_info(_glog, 0, "WARNING", "TurboEdit is not run on streamed observations, use the lite mode or log files");
+		}
+
+		if (_trs2crs_interp)
+		{
+			_trs2crs_table = make_shared<t_gtrs2crs_table>(dynamic_cast<t_gpoleut1*>((*data)[t_gdata::ALLPOLEUT1]), _trs2crs_accuracy);
+			if (_trs2crs_table->build(_beg_time - 300.0, _end_time + 300.0))
+			{
+				// compare with the direct computation, errors in micro arcsec
+				double direct_us = 0.0, table_us = 0.0, max_err = 0.0;
+				_trs2crs_table->benchmark(100, direct_us, table_us, max_err);
+				write_log_info(_glog, 1, "NOTE", "TRS2CRS table: " + int2str(_trs2crs_table->size()) + " nodes, step "
+					+ dbl2str(_trs2crs_table->step(), 1) + " s, max err " + dbl2str(_trs2crs_table->max_err() * RAD2SEC * 1e6)
+					+ " uas, direct " + dbl2str(direct_us, 1) + " us, table " + dbl2str(table_us, 1) + " us, err " + dbl2str(max_err * RAD2SEC * 1e6) + " uas");
+				dynamic_cast<t_gprecisebias*>(_bias_model.get())->set_trs2crs_table(_trs2crs_table);
+			}
+			else
+			{
+				write_log_info(_glog, 1, "WARNING", "can not build the TRS2CRS table (max err " + dbl2str(_trs2crs_table->max_err() * RAD2SEC * 1e6)
+					+ " uas), compute the rotations directly");
+				_trs2crs_table = nullptr;
+			}
+		}
+
+		if (_obs_store && !_obs_queue)
+		{
+			// the edited observations are moved into the store, the epochs are read from it
+			size_t map_bytes = _gall_obs->memory();
+			_gobs_store = make_shared<t_gobsstore>(_gall_obs->sampling());
+			_gall_obs->compact(*_gobs_store, _rec_list, true);
+			write_log_info(_glog, 1, "NOTE", "observation store: " + int2str((int)_gobs_store->rows()) + " rows, "
+				+ dbl2str(_gobs_store->memory() / 1048576.0, 1) + " MB, maps " + dbl2str(map_bytes / 1048576.0, 1)
+				+ " MB released to " + dbl2str(_gall_obs->memory() / 1048576.0, 1) + " MB");
+		}
+
+		if (_sat_state_cache)
+		{
+			_sat_state = make_shared<t_gsatstate>(_gall_nav, dynamic_cast<t_gpoleut1*>((*data)[t_gdata::ALLPOLEUT1]));
+			_sat_state->set_trs2crs_table(_trs2crs_table);
+			dynamic_cast<t_gprecisebias*>(_bias_model.get())->set_sat_state(_sat_state);
+		}
+
 #ifdef USE_OPENMP
 		dynamic_cast<t_gprecisebias*>(_bias_model.get())->set_multi_thread(_rec_list);
 		omp_set_num_threads(_num_threads);
@@ -94,25 +148,8 @@ namespace great
 		chrono::high_resolution_clock::time_point end_epo_time;
 
 		while (_crt_time <= _end_time) {
-			_beg_epo_time = chrono::high_resolution_clock::now();
 			cout << _crt_time.str_ymdhms("-------------------") << " -------------------" << endl;
-			write_log_info(_glog, 0, "NOTE", _crt_time.str_ymdhms("Processing epoch "));
-
-			_initOneEpoch();
-			/* get observation */
-			vector<t_gsatdata> crt_obs = _gall_obs->obs(_rec_list, _crt_time);
-			bool epoch_valid = false;
-			int num_site = _gall_obs->end_obs_sites(_crt_time, _rec_list);
-
-			epoch_valid = _processOneEpoch(_crt_time, crt_obs);
-
-			if (!epoch_valid) {
-				_glog->comment(t_glog::LOG_LV::LOG_ERROR, "t_gpcelsqIF", "ProcessBatch", "Processing failed in epoch");
-			}
-
-			if (_lsq->mode() == LSQMODE::EPO) {
-				_solveEpoch(crt_obs);
-			}
+			_processEpoch("ProcessBatch");
 
 			write_log_info(_glog, 1, "NOTE", _crt_time.str_ymdhms("End Processing epoch "));
 			end_epo_time = chrono::high_resolution_clock::now();
@@ -165,6 +202,123 @@ namespace great
 		return true;
 	}
 
+	bool t_gpcelsqIF::ProcessWindow(t_gallproc* data, const t_gtime& beg, const t_gtime& end, t_gepochqueue* queue)
+	{
+		if (_lsq->mode() != LSQMODE::EPO) {
+			write_log_info(_glog, 0, "ERROR", "sliding window needs lsq_mode EPO");
+			return false;
+		}
+		int window = dynamic_cast<t_gsetproc*>(_gset)->slide_window();
+		double speed = dynamic_cast<t_gsetproc*>(_gset)->replay_speed();
+		if (window < 1) window = 1;
+
+		// streamed observations are not complete at the begin, nothing is prepared over the session
+		_obs_queue = queue;
+		if (_obs_queue) speed = 0.0;
+
+		// the maps are released epoch by epoch, no store kept over the session
+		_obs_store = false;
+
+		if (!InitProc(data, beg, end)) return false;
+
+		// nothing is recovered later, removed pars are only marginalized into NEQ
+		_lsq->set_marginalize(true);
+		_write_equ = false;
+		_amb_last_obs.clear();
+
+		chrono::steady_clock::time_point replay_beg = chrono::steady_clock::now();
+		chrono::high_resolution_clock::time_point end_epo_time;
+		double max_latency = 0.0, sum_latency = 0.0;
+		int num_epoch = 0, max_npar = 0;
+
+		while (_crt_time <= _end_time) {
+			// the epoch is waited for until decoded, the stream ends with all its sources
+			if (_obs_queue && !_obs_queue->wait(_crt_time)) break;
+
+			// the epoch is due at its time since the begin, scaled by the replay speed
+			if (speed > 0.0) {
+				this_thread::sleep_until(replay_beg + chrono::duration_cast<chrono::steady_clock::duration>(
+					chrono::duration<double>(_crt_time.diff(_beg_time) / speed)));
+			}
+			_processEpoch("ProcessWindow");
+			for (int site_i = 0; site_i < _obs_work.size(); site_i++) {
+				for (const auto& obs : _obs_work.obs(site_i)) _amb_last_obs[make_pair(obs.site(), obs.sat())] = _crt_time;
+			}
+			_slideWindow(window);
+
+			end_epo_time = chrono::high_resolution_clock::now();
+			double latency = chrono::duration_cast<chrono::milliseconds>(end_epo_time - _beg_epo_time).count() / 1000.0;
+			int npar = _lsq->_x_solve.parNumber();
+			max_latency = max(max_latency, latency);
+			sum_latency += latency;
+			max_npar = max(max_npar, npar);
+			num_epoch++;
+			cout << _crt_time.str_ymdhms("Finish epoch") << ": " << setw(8) << setprecision(3) << fixed << latency << " sec"
+				<< ", nrec = " << setw(3) << _map_all_equ.size() << ", nobs = " << setw(5) << _obs_crt_num << ", npar = " << setw(5) << npar
+				<< ", sigma0 = " << setw(9) << setprecision(5) << _crt_sigma << endl;
+
+			_crt_time = _crt_time + _obs_intv;
+		}
+
+		writeLogInfo(_glog, 0, "NOTE", "###REMOVE_PAR " + dbl2str(_remove_par_msec / 1000.0) + " sec.");
+		writeLogInfo(_glog, 0, "NOTE", "###COMBINE_EQU " + dbl2str(_cmb_equ_msec / 1000.0) + " sec.");
+		writeLogInfo(_glog, 0, "NOTE", "###WINDOW " + int2str(window) + " epochs, " + int2str(num_epoch) + " epochs processed, latency max "
+			+ dbl2str(max_latency) + " sec mean " + dbl2str(num_epoch ? sum_latency / num_epoch : 0.0) + " sec, npar max " + int2str(max_npar));
+		if (_satclkfile) _satclkfile->flush();
+		return true;
+	}
+
+	bool t_gpcelsqIF::_processEpoch(const string& funct_id)
+	{
+		_beg_epo_time = chrono::high_resolution_clock::now();
+		write_log_info(_glog, 0, "NOTE", _crt_time.str_ymdhms("Processing epoch "));
+
+		_initOneEpoch();
+		/* get observation, built once per site in the workspace */
+		if (_gobs_store) _obs_work.fill(*_gobs_store, _rec_list, _crt_time);
+		else _obs_work.fill(_gall_obs, _rec_list, _crt_time);
+		bool epoch_valid = _processOneEpoch(_crt_time, _obs_work);
+
+		if (!epoch_valid) {
+			_glog->comment(t_glog::LOG_LV::LOG_ERROR, "t_gpcelsqIF", funct_id, "Processing failed in epoch");
+		}
+
+		if (_lsq->mode() == LSQMODE::EPO) {
+			_solveEpoch();
+		}
+		return epoch_valid;
+	}
+
+	void t_gpcelsqIF::_slideWindow(int window)
+	{
+		t_gtime window_beg = _crt_time - (window - 1) * _obs_intv;
+
+		// ambiguities without observations in the window are marginalized, a new one is set up
+		// if the satellite is observed again
+		vector<int> remove_id;
+		for (unsigned int ipar = 0; ipar < _lsq->_x_solve.parNumber(); ipar++) {
+			const t_gpar& par = _lsq->_x_solve[ipar];
+			if (!t_gpar::is_amb(par.parType)) continue;
+			auto iter = _amb_last_obs.find(make_pair(par.site, par.prn));
+			if (iter == _amb_last_obs.end() || iter->second < window_beg) remove_id.push_back(ipar + 1);
+		}
+		if (!remove_id.empty()) {
+			chrono::high_resolution_clock::time_point beg_time = chrono::high_resolution_clock::now();
+			_lsq->remove_parameter(remove_id, false);
+			_lsq->_x_solve.reIndex();
+			_remove_par_msec += chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - beg_time).count();
+			_glog->logInfo("t_gpcelsqIF", "_slideWindow", _crt_time.str_mjdsod("ambiguities marginalized: " + int2str((int)remove_id.size())));
+		}
+
+		for (auto iter = _amb_last_obs.begin(); iter != _amb_last_obs.end();) {
+			if (iter->second < window_beg) iter = _amb_last_obs.erase(iter);
+			else ++iter;
+		}
+
+		// the observations before the window are not needed any more
+		_gall_obs->erase_time(window_beg);
+	}
+
 	bool t_gpcelsqIF::GenerateProduct()
 	{
 		// update clk file
@@ -260,52 +414,82 @@ namespace great
 	}
 
 	bool t_gpcelsqIF::_processOneEpoch(const t_gtime& crt_epoch, std::vector<t_gsatdata>& crt_obs)
+	{
+		_obs_work.fill(crt_obs, _rec_list);
+		return _processOneEpoch(crt_epoch, _obs_work);
+	}
+
+	bool t_gpcelsqIF::_processOneEpoch(const t_gtime& crt_epoch, t_gobsworkspace& work)
 	{
 		string class_id = "t_gpcelsqIF";
 		string funct_id = "_processOneEpoch";
 		_map_all_equ.clear();
 
-		for (auto iter = crt_obs.begin(); iter != crt_obs.end();) {
-			if (iter->sys() == "R" && iter->channel() >= DEF_CHANNEL) {
-				if (_glofrq_num.find(iter->sat()) != _glofrq_num.end()) {
-					iter->channel(_glofrq_num.at(iter->sat()));
-				}
-				else {
-					_glog->logInfo("t_gpcelsqIF", "_processOneEpoch", crt_epoch.str_mjdsod("no useful frequency id for: " + iter->sat()));
-					iter = crt_obs.erase(iter);
-					continue;
+		for (int site_i = 0; site_i < work.size(); site_i++) {
+			vector<t_gsatdata>& site_obs = work.obs(site_i);
+			for (auto iter = site_obs.begin(); iter != site_obs.end();) {
+				if (iter->sys() == "R" && iter->channel() >= DEF_CHANNEL) {
+					if (_glofrq_num.find(iter->sat()) != _glofrq_num.end()) {
+						iter->channel(_glofrq_num.at(iter->sat()));
+					}
+					else {
+						_glog->logInfo("t_gpcelsqIF", "_processOneEpoch", crt_epoch.str_mjdsod("no useful frequency id for: " + iter->sat()));
+						iter = site_obs.erase(iter);
+						continue;
+					}
 				}
+				++iter;
 			}
-			++iter;
 		}
 
-		bool select_obs = _select_obs(crt_epoch, crt_obs);
-		if (!select_obs || !_slip12 || crt_obs.empty()) {
+		bool select_obs = (work.num_obs() > 0);
+		for (int site_i = 0; select_obs && site_i < work.size(); site_i++) {
+			select_obs = _select_obs(crt_epoch, work.obs(site_i));
+		}
+		if (!select_obs || !_slip12) {
 			_glog->logError("t_gpcelsqIF", "_processOneEpoch", crt_epoch.str_mjdsod("select_obs failed"));
 			return false;
 		}
 
-		// prepare Obs
-		map<string, vector<t_gsatdata> > map_site_obs;
-		vector<t_gsatdata> crt_obs_new;
-		for (const auto& crt_rec : _rec_list) {
-			vector<t_gsatdata> crt_rec_obs;
+		// prepare Obs, in place in the workspace
+		vector<int> vec_sites;
+		vector<t_gtriple*> qc_crd;
+		vector<t_gqcstate*> qc_state;
+		for (int site_i = 0; site_i < work.size(); site_i++) {
+			const string& crt_rec = work.site(site_i);
+			vector<t_gsatdata>& crt_rec_obs = work.obs(site_i);
 			// get all the obs for the rec
-			bool select_valid = _select_rec_obs(crt_rec, crt_epoch, crt_obs, crt_rec_obs);
+			bool select_valid = _select_rec_obs(crt_rec, crt_epoch, crt_rec_obs);
 			if (!select_valid) {
 				_glog->logInfo("t_gpcelsqIF", "_processOneEpoch", crt_epoch.str_mjdsod("no useful data : " + crt_rec));
 				continue;
 			}
-			if (_crd_est != CONSTRPAR::KIN) _quality_control->processOneEpoch(crt_epoch, crt_rec, _rec_crds[crt_rec], crt_rec_obs);
+			vec_sites.push_back(site_i);
+			// the states of the sites are added here, the loop below only looks them up
+			if (_crd_est != CONSTRPAR::KIN) {
+				qc_crd.push_back(&_rec_crds[crt_rec]);
+				qc_state.push_back(&_quality_control->site_state(crt_rec));
+			}
+		}
 
-			//number of sat less than 4 continue
-			if (crt_rec_obs.size() < 4) {
-				continue;
+		// quality control, each site modifies only its own obs and state
+		if (_crd_est != CONSTRPAR::KIN) {
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (int i = 0; i < vec_sites.size(); i++) {
+				_quality_control->processOneEpoch(crt_epoch, work.site(vec_sites[i]), *qc_crd[i], work.obs(vec_sites[i]), *qc_state[i]);
 			}
-			map_site_obs[crt_rec] = crt_rec_obs;
-			crt_obs_new.insert(crt_obs_new.end(), crt_rec_obs.begin(), crt_rec_obs.end());
 		}
 
+		//number of sat less than 4 continue
+		vec_sites.erase(remove_if(vec_sites.begin(), vec_sites.end(), [&work](int site_i) {
+			if (work.obs(site_i).size() >= 4) return false;
+			work.obs(site_i).clear();
+			return true;
+		}), vec_sites.end());
+
+		vector<t_gsatdata>& crt_obs_new = work.gather();
 		chrono::high_resolution_clock::time_point beg_time = chrono::high_resolution_clock::now();
 		bool updata_valid = _lsq->update_parameter(crt_epoch, crt_obs_new, _matrix_remove, _write_equ);
 		chrono::high_resolution_clock::time_point end_time = chrono::high_resolution_clock::now();
@@ -316,36 +500,48 @@ namespace great
 			return false;
 		}
 
-		vector<string> vec_sites;
-		for (const auto& item : map_site_obs) {
-			vec_sites.push_back(item.first);
-		}
 		if (vec_sites.empty()) return false;
 
 		beg_time = chrono::high_resolution_clock::now();
+		if (_sat_state) {
+			_sat_state->update(crt_epoch, work.sats());
+		}
+
+		if (_neq_thread_reduce && _lsq->mode() != LSQMODE::EPO) {
+			_processOneEpoch_reduce(crt_epoch, vec_sites, work);
+			end_time = chrono::high_resolution_clock::now();
+			_cmb_equ_msec += chrono::duration_cast<chrono::milliseconds>(end_time - beg_time).count();
+			_glog->logDebug("t_gpcelsqIF", "_processOneEpoch", "Finish form equations");
+			return true;
+		}
+
 		t_gmutex add_mtx;
 		// multi-thread  Process REC [Use OpenMP]
 #ifdef USE_OPENMP
 #pragma omp parallel for
 #endif
-		for (int site_i = 0; site_i < vec_sites.size(); site_i++) {
+		for (int i = 0; i < vec_sites.size(); i++) {
 			t_glsqEquationMatrix equ_temp;
-			string rec_temp = vec_sites[site_i];
+			string rec_temp = work.site(vec_sites[i]);
 			// Process this site and get the equations
-			bool proc_site = _processOneRec_thread_safe(crt_epoch, rec_temp, map_site_obs[rec_temp], equ_temp);
+			bool proc_site = _processOneRec_thread_safe(crt_epoch, rec_temp, work.obs(vec_sites[i]), equ_temp);
 			if (!proc_site) {
 				cout << crt_epoch.str_ymdhms(rec_temp + " has no equations ", false, false) << endl;
 				_glog->logInfo("t_gpcelsqIF", "_processOneEpoch", crt_epoch.str_mjdsod("no useful equations : " + rec_temp));
 				continue;
 			}
 
+			// form the local NEQ block of this site outside of the lock
+			t_glsqNEQBlock block_temp;
+			if (_lsq->mode() != LSQMODE::EPO) block_temp.form(equ_temp);
+
 			// add the new equations
 			add_mtx.lock();
 			if (_lsq->mode() == LSQMODE::EPO) {
 				if (equ_temp.num_equ() > 0) _map_all_equ[rec_temp] = equ_temp;
 			}
 			else {
-				_lsq->add_equation(equ_temp, crt_epoch, _write_equ);
+				_lsq->add_equation(block_temp, equ_temp, crt_epoch, _write_equ);
 				_obs_crt_num = _lsq->get_equ_obs_total_num();
 			}
 			add_mtx.unlock();
@@ -356,6 +552,43 @@ namespace great
 		return true;
 	}
 
+	void t_gpcelsqIF::_processOneEpoch_reduce(const t_gtime& crt_epoch, const vector<int>& vec_sites, t_gobsworkspace& work)
+	{
+		int num_site = vec_sites.size();
+		vector<t_glsqEquationMatrix> site_equ(num_site);
+		vector<t_glsqNEQBlock> site_block(num_site);
+		vector<char> site_valid(num_site, 0);
+
+		// each site writes only its own slot, no lock is needed
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int i = 0; i < num_site; i++) {
+			const string& rec_temp = work.site(vec_sites[i]);
+			bool proc_site = _processOneRec_thread_safe(crt_epoch, rec_temp, work.obs(vec_sites[i]), site_equ[i]);
+			if (!proc_site) {
+				_glog->logInfo("t_gpcelsqIF", "_processOneEpoch", crt_epoch.str_mjdsod("no useful equations : " + rec_temp));
+				continue;
+			}
+			site_block[i].form(site_equ[i]);
+			site_valid[i] = 1;
+		}
+
+		// reduce in the order of sites
+		vector<const t_glsqNEQBlock*> blocks;
+		vector<const t_glsqEquationMatrix*> equs;
+		for (int i = 0; i < num_site; i++) {
+			if (!site_valid[i]) {
+				cout << crt_epoch.str_ymdhms(work.site(vec_sites[i]) + " has no equations ", false, false) << endl;
+				continue;
+			}
+			blocks.push_back(&site_block[i]);
+			equs.push_back(&site_equ[i]);
+		}
+		_lsq->add_equation(blocks, equs, crt_epoch, _write_equ);
+		_obs_crt_num = _lsq->get_equ_obs_total_num();
+	}
+
 	bool t_gpcelsqIF::_processOneRec_thread_safe(const t_gtime& crt_epoch, const std::string& crt_rec, std::vector<t_gsatdata>& crt_obs, t_glsqEquationMatrix& equ_result)
 	{
 		const string class_id = "t_gpcelsqIF";
@@ -408,7 +641,7 @@ namespace great
 		return true;
 	}
 
-	bool t_gpcelsqIF::_solveEpoch(vector<t_gsatdata>& crt_obs)
+	bool t_gpcelsqIF::_solveEpoch()
 	{
 		_glog->logDebug("t_gpcelsqIF", "_solveEpoch", "Begin solve epoch clock");
 		for (const auto& equ : _map_all_equ) {
@@ -419,12 +652,11 @@ namespace great
 		_check_ref_clk(_lsq);
 
 		if (!_epo_solved && _obs_crt_num > _sat_list.size() + _rec_list.size()) {
-			t_glsq lsqepo(*_lsq);
 			try {
-				lsqepo.solve_x();
-				_get_clk_crt(&lsqepo, false);
+				// solved in the work matrix of _lsq, which itself is not changed
+				_crt_sigma = _lsq->solve_x_epo(_dx_epo);
+				_get_clk_crt(_lsq, _dx_epo, false);
 				_epo_solved = true;
-				_crt_sigma = lsqepo.sigma0();
 			}
 			catch (...) {
 				_glog->comment(t_glog::LOG_LV::LOG_ERROR, "t_gpcelsqIF", "_solveEpoch", _crt_time.str_mjdsod("solve_x throw error"));
@@ -498,9 +730,8 @@ namespace great
 		return false;
 	}
 
-	void t_gpcelsqIF::_get_clk_crt(t_glsq* lsq, bool update_std)
+	void t_gpcelsqIF::_get_clk_crt(t_glsq* lsq, const ColumnVector& dx, bool update_std)
 	{
-		const ColumnVector& dx = lsq->dx();
 		for (const auto& sat : _sat_list) {
 			int idx = lsq->_x_solve.getParam("", par_type::CLK_SAT, sat, _crt_time, _crt_time);
 			if (idx < 0) continue;
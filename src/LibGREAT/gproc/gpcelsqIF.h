@@ -12,8 +12,10 @@
 #define GPCELSQIF_H
 
 #include "gmodels/glsqprocIF.h"
+#include "gmodels/gobsworkspace.h"
 #include "gexport/ExportLibGREAT.h"
 #include "gcoders/sp3.h"
+#include "gutils/gepochqueue.h"
 
 namespace great
 {
@@ -33,6 +35,15 @@ namespace great
 		bool InitProc(t_gallproc* data, const t_gtime& beg, const t_gtime& end);
 		/** @brief process batch */
 		bool ProcessBatch(t_gallproc* data, const t_gtime&beg, const t_gtime& end) override;
+		/**
+		* @brief real-time clock estimation in a sliding window (EPO mode)
+		* @note the satellite clocks are solved and written every epoch, parameters leaving the window
+		*       are marginalized into NEQ instead of written to the tempfile and the observations leaving
+		*       the window are erased, so the storage does not grow with the session length.
+		*       With replay_speed the epochs are processed at this multiple of real time.
+		*       With a queue the observations are streamed, each epoch is processed once decoded.
+		*/
+		bool ProcessWindow(t_gallproc* data, const t_gtime& beg, const t_gtime& end, t_gepochqueue* queue = nullptr);
 		/** @brief generate product */
 		bool GenerateProduct() override;
 
@@ -53,22 +64,31 @@ namespace great
 		bool _initOneEpoch();
 		/** @brief process one epoch data */
 		bool _processOneEpoch(const t_gtime& crt_epoch, vector<t_gsatdata>& crt_obs) override;
+		/** @brief process one epoch data of the workspace, the obs are selected and corrected in place */
+		bool _processOneEpoch(const t_gtime& crt_epoch, t_gobsworkspace& work);
+		/** @brief form the equations of the sites of work without lock and reduce them into lsq in site order */
+		void _processOneEpoch_reduce(const t_gtime& crt_epoch, const vector<int>& vec_sites, t_gobsworkspace& work);
 		/** @brief process one receiver data */
 		bool _processOneRec_thread_safe(const t_gtime& crt_epoch, const string& crt_rec, vector<t_gsatdata>& crt_obs, t_glsqEquationMatrix& equ_result);
 		/** @brief solve one epoch equation */
-		bool _solveEpoch(vector<t_gsatdata>& crt_obs);
+		bool _solveEpoch();
+		/** @brief process _crt_time (obs of the store or the maps), solved in EPO mode, errors logged for funct_id */
+		bool _processEpoch(const string& funct_id);
+		/** @brief marginalize the ambiguities without observations in the window and erase the obs leaving it */
+		void _slideWindow(int window);
 		/** @brief whether reference clock has observations in current epoch */
 		bool _ref_clk_valid(t_glsq* lsq);
 		/** @brief check and reset the reference clock */
 		bool _check_ref_clk(t_glsq* lsq);
-		/** @brief get current satellite clocks */
-		void _get_clk_crt(t_glsq* lsq, bool update_std=true);
+		/** @brief get current satellite clocks from the correction dx of lsq */
+		void _get_clk_crt(t_glsq* lsq, const ColumnVector& dx, bool update_std=true);
 		/** @brief get current obs num */
 		void _get_obs_crt_num();
 		/** @brief find satellite with maximum observations */
 		string _sat_obs_max(t_glsq* lsq);
 
 		shared_ptr<t_gqualitycontrol>  _quality_control = nullptr;
+		t_gobsworkspace _obs_work;     ///< obs of the current epoch
 		t_gio* _gioout = nullptr;
 
 		string _ref_clk;     //reference clock
@@ -86,6 +106,9 @@ namespace great
 		map<string, double> _clk_std_crt;
 		double _crt_sigma = 0.0;
 		bool _epo_solved = false;
+		ColumnVector _dx_epo;  ///< correction of the epoch solution
+		map<pair<string, string>, t_gtime> _amb_last_obs;  ///< last epoch with obs of site/sat in the sliding window
+		t_gepochqueue* _obs_queue = nullptr;  ///< epochs of the streamed observations, not owned
 	};
 }
 
@@ -10,6 +10,7 @@
  */
 #include <iomanip>
 #include <memory>
+#include <cstring>
 
 #include "gproc/gqualitycontrol.h"
 #include "gmodels/gbancroft.h"
@@ -28,38 +29,70 @@ namespace great {
 
 	}
 
-	void t_gsmooth::smooth_range_obs(vector<t_gsatdata>& obsdata, const t_gtime& now)
+	int t_gqcstate::sat(const string& sat)
+	{
+		auto iter = sat_index.find(sat);
+		if (iter != sat_index.end()) return iter->second;
+
+		int slot = sat_index.size();
+		sat_index[sat] = slot;
+		smt_beg.push_back(FIRST_TIME);
+		orig_obs.resize(orig_obs.size() + NBAND, X);
+		orig_val.resize(orig_val.size() + NBAND, 0.0);
+		smt_range.resize(smt_range.size() + nsig, 0.0);
+		return slot;
+	}
+
+	int t_gqcstate::sig(GOBS gobs)
+	{
+		if (sig_index.empty()) sig_index.assign(X + 1, -1);
+		if (sig_index[gobs] >= 0) return sig_index[gobs];
+
+		// new column, rows of all satellites moved to the new stride
+		int nsat = smt_beg.size();
+		vector<double> range(nsat * (nsig + 1), 0.0);
+		for (int isat = 0; isat < nsat; isat++) {
+			for (int isig = 0; isig < nsig; isig++) range[isat * (nsig + 1) + isig] = smt_range[isat * nsig + isig];
+		}
+		smt_range.swap(range);
+		sig_index[gobs] = nsig;
+		return nsig++;
+	}
+
+	int t_gqcstate::band(GOBSBAND band)
+	{
+		if (band >= BAND_1 && band <= BAND_9) return band;
+		if (band >= BAND_A && band <= BAND_D) return band - BAND_A + 10;
+		return 0;
+	}
+
+	void t_gsmooth::smooth_range_obs(vector<t_gsatdata>& obsdata, const t_gtime& now, t_gqcstate& state) const
 	{
 		if (_smoothModel == SMOOTH_MODEL::SMT_NONE) return;
 
 		// doppler
 		if (_smoothModel == SMOOTH_MODEL::SMT_DOPPLER)
 		{
-			_doppler_smt_range(obsdata, now);
+			_doppler_smt_range(obsdata, now, state);
 		}
 		// phase
 		else
 		{
-			_phase_smt_range(obsdata, now);
+			_phase_smt_range(obsdata, now, state);
 		}
 	}
 
-	void t_gsmooth::_doppler_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now)
+	void t_gsmooth::_doppler_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now, t_gqcstate& state) const
 	{		
 		for (auto &oneObs : obsdata)
 		{
 			if (oneObs.getrangestate("smooth_range")) continue;
-			string site = oneObs.site();
-			GSYS   gsys = oneObs.gsys();
-			string gsat = oneObs.sat();
+			int isat = state.sat(oneObs.sat());
 
-			if (_smt_beg_time.find(site) == _smt_beg_time.end() || _smt_beg_time[site].find(gsat) == _smt_beg_time[site].end())
-			{
-				_smt_beg_time[site][gsat] = now;
-			}
-			else if (now.diff(_smt_beg_time[site][gsat]) > _smoothWindow * _sampling)
+			t_gtime& beg_time = state.smt_beg[isat];
+			if (beg_time == FIRST_TIME || now.diff(beg_time) > _smoothWindow * _sampling)
 			{
-				_smt_beg_time[site][gsat] = now;
+				beg_time = now;
 			}
 
 			vector<GOBS> vec_obs = oneObs.obs();
@@ -83,19 +116,22 @@ namespace great {
 				double obsP = oneObs.obs_C(GOBSP);  // m
 				double obsD = oneObs.obs_D(GOBSD);  // m/s
 
-				if (_smt_beg_time[site][gsat] == now || GOBSD != _pre_orig_val[site][gsat][band].first
+				int isig = state.sig(GOBSP);
+				int iband = isat * t_gqcstate::NBAND + t_gqcstate::band(band);
+				double& pre_smt = state.smt_range[isat * state.nsig + isig];
+
+				if (beg_time == now || GOBSD == X || GOBSD != state.orig_obs[iband]
 					|| oneObs.getoutliers(GOBSD) > 0)
 				{
-					_pre_orig_val[site][gsat][band] = make_pair(GOBSD, obsD);
-					_pre_smt_range[site][gsat][GOBSP] = obsP;
-					_smt_beg_time[site][gsat] == now;
+					state.orig_obs[iband] = GOBSD;
+					state.orig_val[iband] = obsD;
+					pre_smt = obsP;
 				}
 				else
 				{
-					double smt = _smoothFactor * obsP + (1.0 - _smoothFactor) * (_pre_smt_range[site][gsat][GOBSP] - obsD);
-					_pre_orig_val[site][gsat][band].first = GOBSD;
-					_pre_orig_val[site][gsat][band].second = obsD;
-					_pre_smt_range[site][gsat][GOBSP] = smt;
+					double smt = _smoothFactor * obsP + (1.0 - _smoothFactor) * (pre_smt - obsD);
+					state.orig_val[iband] = obsD;
+					pre_smt = smt;
 					oneObs.resetobs(GOBSP, smt);
 					oneObs.setrangestate("smooth_range", true);
 				}
@@ -104,22 +140,17 @@ namespace great {
 
 	}
 	
-	void t_gsmooth::_phase_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now)
+	void t_gsmooth::_phase_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now, t_gqcstate& state) const
 	{
 		for (auto &oneObs : obsdata)
 		{
 			if (oneObs.getrangestate("smooth_range")) continue;
-			string site = oneObs.site();
-			GSYS   gsys = oneObs.gsys();
-			string gsat = oneObs.sat();
+			int isat = state.sat(oneObs.sat());
 
-			if (_smt_beg_time.find(site) == _smt_beg_time.end() || _smt_beg_time[site].find(gsat) == _smt_beg_time[site].end())
-			{
-				_smt_beg_time[site][gsat] = now;
-			}
-			else if (now.diff(_smt_beg_time[site][gsat]) > _smoothWindow * _sampling)
+			t_gtime& beg_time = state.smt_beg[isat];
+			if (beg_time == FIRST_TIME || now.diff(beg_time) > _smoothWindow * _sampling)
 			{
-				_smt_beg_time[site][gsat] = now;
+				beg_time = now;
 			}
 
 			vector<GOBS> vec_obs = oneObs.obs();
@@ -140,20 +171,23 @@ namespace great {
 				double obsP = oneObs.obs_C(GOBSP);
 				double obsL = oneObs.obs_L(GOBSL);
 
-				if (_smt_beg_time[site][gsat] == now || GOBSL != _pre_orig_val[site][gsat][band].first 
+				int isig = state.sig(GOBSP);
+				int iband = isat * t_gqcstate::NBAND + t_gqcstate::band(band);
+				double& pre_smt = state.smt_range[isat * state.nsig + isig];
+
+				if (beg_time == now || GOBSL == X || GOBSL != state.orig_obs[iband]
 					|| oneObs.getlli(GOBSL) > 0)
 				{
-					_pre_orig_val[site][gsat][band] = make_pair(GOBSL, obsL);
-					_pre_smt_range[site][gsat][GOBSP] = obsP;
-					_smt_beg_time[site][gsat] == now;
+					state.orig_obs[iband] = GOBSL;
+					state.orig_val[iband] = obsL;
+					pre_smt = obsP;
 				}
 				else
 				{
 					double smt = _smoothFactor * obsP + (1.0 - _smoothFactor) * 
-						(_pre_smt_range[site][gsat][GOBSP] + obsL - _pre_orig_val[site][gsat][band].second);
-					_pre_orig_val[site][gsat][band].first = GOBSL;
-					_pre_orig_val[site][gsat][band].second = obsL;
-					_pre_smt_range[site][gsat][GOBSP] = smt;
+						(pre_smt + obsL - state.orig_val[iband]);
+					state.orig_val[iband] = obsL;
+					pre_smt = smt;
 					oneObs.resetobs(GOBSP, smt);
 					oneObs.setrangestate("smooth_range", true);
 				}
@@ -178,16 +212,51 @@ namespace great {
 		_set = settings;
 
 		// set Wanninger & Beer 
-		_IGSO_MEO_Corr[BAND_2]["IGSO"] = { {0,-0.55}, {1,-0.40}, {2,-0.34}, {3,-0.23}, {4,-0.15}, {5,-0.04}, {6,0.09}, {7,0.19}, {8,0.27}, {9,0.35} }; // B1
-		_IGSO_MEO_Corr[BAND_7]["IGSO"] = { {0,-0.71}, {1,-0.36}, {2,-0.33}, {3,-0.19}, {4,-0.14}, {5,-0.03}, {6,0.08}, {7,0.17}, {8,0.24}, {9,0.33} }; // B2
-		_IGSO_MEO_Corr[BAND_6]["IGSO"] = { {0,-0.27}, {1,-0.23}, {2,-0.21}, {3,-0.15}, {4,-0.11}, {5,-0.04}, {6,0.05}, {7,0.14}, {8,0.19}, {9,0.32} }; // B3
+		const double corr[3][2][10] = {
+			{ {-0.55, -0.40, -0.34, -0.23, -0.15, -0.04, 0.09, 0.19, 0.27, 0.35},    // B1 IGSO
+			  {-0.47, -0.38, -0.32, -0.23, -0.11,  0.06, 0.34, 0.69, 0.97, 1.05} },  // B1 MEO
+			{ {-0.71, -0.36, -0.33, -0.19, -0.14, -0.03, 0.08, 0.17, 0.24, 0.33},    // B2 IGSO
+			  {-0.40, -0.31, -0.26, -0.18, -0.06,  0.09, 0.28, 0.48, 0.64, 0.69} },  // B2 MEO
+			{ {-0.27, -0.23, -0.21, -0.15, -0.11, -0.04, 0.05, 0.14, 0.19, 0.32},    // B3 IGSO
+			  {-0.22, -0.15, -0.13, -0.10, -0.04,  0.05, 0.14, 0.27, 0.36, 0.47} }   // B3 MEO
+		};
+		memcpy(_IGSO_MEO_Corr, corr, sizeof(corr));
+	}
+
+	void t_gbds_codebias_cor::_correct(const string& sat, double elev, t_gobsgnss& obsdata) const
+	{
+		int type = (sat == "C11" || sat == "C12" || sat == "C14") ? 1 : 0; // MEO : IGSO
+
+		// get correction of B1/B2/B3
+		double elev0 = elev / 10.0;
+		int elev0_int = floor(elev0);
+		double band_cor[3];
+		for (int i = 0; i < 3; i++)
+		{
+			const double* corr = _IGSO_MEO_Corr[i][type];
+			if      (elev0_int < 0)  band_cor[i] = corr[0];
+			else if (elev0_int >= 9) band_cor[i] = corr[9];
+			else                     band_cor[i] = corr[elev0_int] * (1.0 - elev0 + elev0_int) + corr[elev0_int + 1] * (elev0 - elev0_int);
+		}
 
-		_IGSO_MEO_Corr[BAND_2]["MEO"]  = { {0,-0.47}, {1,-0.38}, {2,-0.32}, {3,-0.23}, {4,-0.11}, {5,0.06}, {6,0.34}, {7,0.69}, {8,0.97}, {9,1.05} }; //B1
-		_IGSO_MEO_Corr[BAND_7]["MEO"]  = { {0,-0.40}, {1,-0.31}, {2,-0.26}, {3,-0.18}, {4,-0.06}, {5,0.09}, {6,0.28}, {7,0.48}, {8,0.64}, {9,0.69} }; //B2
-		_IGSO_MEO_Corr[BAND_6]["MEO"]  = { {0,-0.22}, {1,-0.15}, {2,-0.13}, {3,-0.10}, {4,-0.04}, {5,0.05}, {6,0.14}, {7,0.27}, {8,0.36}, {9,0.47} }; //B3
+		vector<GOBS> obs_vec = obsdata.obs();
+		for (auto obs_type : obs_vec)
+		{
+			// skip not code obs
+			if (!t_gobs(obs_type).is_code()) continue;
+
+			GOBSBAND b = t_gobs(obs_type).band();
+			double obs_P = obsdata.obs_C(obs_type);
+
+			if      (b == BAND_2) obs_P += band_cor[0];
+			else if (b == BAND_7) obs_P += band_cor[1];
+			else if (b == BAND_6) obs_P += band_cor[2];
+			obsdata.resetobs(obs_type, obs_P);
+			obsdata.setrangestate("bds_code_bias", true);
+		}
 	}
 
-	void t_gbds_codebias_cor::apply_IGSO_MEO(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata)
+	void t_gbds_codebias_cor::apply_IGSO_MEO(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata) const
 	{
 		if (!this->_correct_bds_code_bias || obsdata.size() == 0 || !gnav) return;
 
@@ -197,9 +266,6 @@ namespace great {
 		}
 
 		// Calculate elevation and Correct Obs
-		map<GOBSBAND, double> Band_cor;
-		string sat_type;
-
 		vector<t_gsatdata>::iterator data;
 		for (data = obsdata.begin(); data != obsdata.end();)
 		{
@@ -219,9 +285,6 @@ namespace great {
 				data++;
 				continue;
 			}
-			if (sat == "C11" || sat == "C12" || sat == "C14") sat_type = "MEO";
-			else                                              sat_type = "IGSO";
-
 
 			if (data->satcrd().zero())
 			{
@@ -237,53 +300,13 @@ namespace great {
 			double elev = (rec_crd[0] * rec_sat_vector[0] + rec_crd[1] * rec_sat_vector[1] + rec_crd[2] * rec_sat_vector[2]) / rec_crd.norm() / distance;
 			elev = 90.0 - acos(elev) * 180.0 / G_PI;
 
-			// get correction
-			double elev0 = elev / 10.0;
-			int elev0_int = floor(elev0);
-			if (elev0_int < 0)
-			{
-				Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][0];
-				Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][0];
-				Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][0];
-			}
-			else if (elev0_int >= 9)
-			{
-				Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][9];
-				Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][9];
-				Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][9];
-			}
-			else
-			{
-				Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-					+ _IGSO_MEO_Corr[BAND_2][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-				Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-					+ _IGSO_MEO_Corr[BAND_7][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-				Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-					+ _IGSO_MEO_Corr[BAND_6][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-			}
-
-			vector<GOBS> obs_vec = data->obs();
-			for (auto obs_type : obs_vec)
-			{
-				// skip not code obs
-				if (!t_gobs(obs_type).is_code())
-				{
-					continue;
-				}
-
-				GOBSBAND b = t_gobs(obs_type).band();
-				double obs_P = data->obs_C(obs_type);
-
-				obs_P += Band_cor[b];
-				data->resetobs(obs_type, obs_P);
-				data->setrangestate("bds_code_bias", true);
-			}
+			_correct(sat, elev, *data);
 
 			data++;
 		}
 	}
 
-	void t_gbds_codebias_cor::apply_IGSO_MEO_obs(t_gtriple& rec_crd, t_gallnav* gnav, const shared_ptr<t_gobsgnss>& obsdata)
+	void t_gbds_codebias_cor::apply_IGSO_MEO_obs(t_gtriple& rec_crd, t_gallnav* gnav, const shared_ptr<t_gobsgnss>& obsdata) const
 	{
 		if (!_correct_bds_code_bias || !obsdata || !gnav || 
 			rec_crd.zero() || obsdata->getrangestate("bds_code_bias")) return;
@@ -299,94 +322,22 @@ namespace great {
 		double distance = rec_sat_vector.norm();
 		double elev = (rec_crd[0] * rec_sat_vector[0] + rec_crd[1] * rec_sat_vector[1] + rec_crd[2] * rec_sat_vector[2]) / rec_crd.norm() / distance;
 		elev = 90.0 - acos(elev) * 180.0 / G_PI;
-		double elev0 = elev / 10.0;
-		int elev0_int = floor(elev0);
 
 		// Calculate elevation and Correct Obs
-		string sat_type;
-		if (sat == "C11" || sat == "C12" || sat == "C14") sat_type = "MEO";
-		else sat_type = "IGSO";
-		map<GOBSBAND, double> Band_cor;
-		if (elev0_int < 0) {
-			Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][0];
-			Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][0];
-			Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][0];
-		}
-		else if (elev0_int >= 9) {
-			Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][9];
-			Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][9];
-			Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][9];
-		}
-		else {
-			Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-				+ _IGSO_MEO_Corr[BAND_2][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-			Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-				+ _IGSO_MEO_Corr[BAND_7][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-			Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-				+ _IGSO_MEO_Corr[BAND_6][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-		}
-
-		vector<GOBS> obs_vec = obsdata->obs();
-		for (auto obs_type : obs_vec)
-		{
-			if (!t_gobs(obs_type).is_code()) continue;
-
-			GOBSBAND b = t_gobs(obs_type).band();
-			double obs_P = obsdata->obs_C(obs_type);
-
-			obs_P += Band_cor[b];
-			obsdata->resetobs(obs_type, obs_P);
-			obsdata->setrangestate("bds_code_bias", true);
-		}
+		_correct(sat, elev, *obsdata);
 	}
 
-	void t_gbds_codebias_cor::apply_IGSO_MEO_ele(const double& elev, t_gsatdata& obsdata)
+	void t_gbds_codebias_cor::apply_IGSO_MEO_ele(const double& elev, t_gsatdata& obsdata) const
 	{
 		if (!_correct_bds_code_bias || obsdata.obs_empty() || obsdata.getrangestate("bds_code_bias")) return;
 		const string& sat = obsdata.sat();
 		if (sat.substr(0, 1) != "C" || sat > "C17" || sat < "C06") return;
-		double elev0 = elev / 10.0;
-		int elev0_int = floor(elev0);
-
-		// Calculate elevation and Correct Obs
-		string sat_type;
-		if (sat == "C11" || sat == "C12" || sat == "C14") sat_type = "MEO";
-		else sat_type = "IGSO";
-		map<GOBSBAND, double> Band_cor;
-		if (elev0_int < 0) {
-			Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][0];
-			Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][0];
-			Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][0];
-		}
-		else if (elev0_int >= 9) {
-			Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][9];
-			Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][9];
-			Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][9];
-		}
-		else {
-			Band_cor[BAND_2] = _IGSO_MEO_Corr[BAND_2][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-				+ _IGSO_MEO_Corr[BAND_2][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-			Band_cor[BAND_7] = _IGSO_MEO_Corr[BAND_7][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-				+ _IGSO_MEO_Corr[BAND_7][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-			Band_cor[BAND_6] = _IGSO_MEO_Corr[BAND_6][sat_type][elev0_int] * (1.0 - elev0 + elev0_int)
-				+ _IGSO_MEO_Corr[BAND_6][sat_type][elev0_int + 1] * (elev0 - elev0_int);
-		}
-
-		vector<GOBS> obs_vec = obsdata.obs();
-		for (auto obs_type : obs_vec)
-		{
-			if (!t_gobs(obs_type).is_code()) continue;
-
-			GOBSBAND b = t_gobs(obs_type).band();
-			double obs_P = obsdata.obs_C(obs_type);
 
-			obs_P += Band_cor[b];
-			obsdata.resetobs(obs_type, obs_P);
-			obsdata.setrangestate("bds_code_bias", true);
-		}
+		// Correct Obs
+		_correct(sat, elev, obsdata);
 	}
 
-	bool t_gbds_codebias_cor::_recAprCoordinate(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata)
+	bool t_gbds_codebias_cor::_recAprCoordinate(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata) const
 	{
 		Matrix BB;
 
@@ -403,10 +354,17 @@ namespace great {
 				continue;
 			}
 
-			GSYS gs = iter->gsys();
-
-			GOBSBAND b1 = _band_index[gs][FREQ_1];
-			GOBSBAND b2 = _band_index[gs][FREQ_2];
+			// read only, the bands of the system looked up without insertion
+			auto band_iter = _band_index.find(iter->gsys());
+			if (band_iter == _band_index.end())
+			{
+				iter++;
+				continue;
+			}
+			auto b1_iter = band_iter->second.find(FREQ_1);
+			auto b2_iter = band_iter->second.find(FREQ_2);
+			GOBSBAND b1 = (b1_iter == band_iter->second.end()) ? BAND : b1_iter->second;
+			GOBSBAND b2 = (b2_iter == band_iter->second.end()) ? BAND : b2_iter->second;
 
 			GOBS l1 = iter->select_phase(b1);
 			GOBS l2 = iter->select_phase(b2);
@@ -687,10 +645,15 @@ namespace great {
     }
 
 	int t_gqualitycontrol::processOneEpoch(const t_gtime& now, const string& rec, t_gtriple& rec_crd, vector<t_gsatdata>& obsdata)
+	{
+		return processOneEpoch(now, rec, rec_crd, obsdata, site_state(rec));
+	}
+
+	int t_gqualitycontrol::processOneEpoch(const t_gtime& now, const string& rec, t_gtriple& rec_crd, vector<t_gsatdata>& obsdata, t_gqcstate& state) const
 	{
 		this->_bds_codebias_cor.apply_IGSO_MEO(rec, rec_crd, _gnav, obsdata);
 
-		this->_smooth_range.smooth_range_obs(obsdata, now);
+		this->_smooth_range.smooth_range_obs(obsdata, now, state);
 
 		return 1;
 	}
@@ -34,6 +34,32 @@ namespace great
 		SMT_NONE
 	};
 
+	/**
+	 * @brief quality control state of one station
+	 * @note satellites and code signals are indexed once per station and the smoothing values
+	 *       are kept in flat arrays indexed by the slots, so that the stations can be processed
+	 *       in parallel without sharing any state.
+	 */
+	struct LibGREAT_LIBRARY_EXPORT t_gqcstate
+	{
+		static const int NBAND = 14;     ///< number of band slots
+
+		map<string, uint16_t> sat_index; ///< slot of each satellite
+		vector<int16_t>       sig_index; ///< slot of each code GOBS, -1 if never smoothed
+		int                   nsig = 0;  ///< number of signal slots
+		vector<t_gtime>       smt_beg;   ///< smoothing begin time, [sat]
+		vector<GOBS>          orig_obs;  ///< phase/doppler of the previous epoch, [sat * NBAND + band]
+		vector<double>        orig_val;  ///< value of orig_obs, [sat * NBAND + band]
+		vector<double>        smt_range; ///< smoothed range of the previous epoch, [sat * nsig + sig]
+
+		/** @brief slot of the satellite, added if new */
+		int sat(const string& sat);
+		/** @brief slot of the code signal, added if new */
+		int sig(GOBS gobs);
+		/** @brief slot of the band, 0 if unknown */
+		static int band(GOBSBAND band);
+	};
+
 	class LibGREAT_LIBRARY_EXPORT t_gsmooth
 	{
 	public:
@@ -48,21 +74,21 @@ namespace great
 		 */
 		virtual ~t_gsmooth() {};
 
-		void smooth_range_obs(vector<t_gsatdata>& obsdata, const t_gtime& now);
+		/**
+		 * @brief smooth the range of one station
+		 * @note only the state of the station is modified, thread safe for different stations
+		 */
+		void smooth_range_obs(vector<t_gsatdata>& obsdata, const t_gtime& now, t_gqcstate& state) const;
 
 	private:
 
-		void _doppler_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now);
-		void _phase_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now);
+		void _doppler_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now, t_gqcstate& state) const;
+		void _phase_smt_range(vector<t_gsatdata>& obsdata, const t_gtime& now, t_gqcstate& state) const;
 
 		SMOOTH_MODEL                    _smoothModel;
 		int                             _smoothWindow;
 		double                          _smoothFactor;
 		double                          _sampling;
-		// site/sat/range_obs/pre_smt_value
-		map<string, map<string, map<GOBS, double> > >                   _pre_smt_range;
-		map<string, map<string, t_gtime > >                             _smt_beg_time;
-		map<string, map<string, map<GOBSBAND, pair<GOBS, double> > > >  _pre_orig_val;
 
 	};
 
@@ -75,9 +101,13 @@ namespace great
 		t_gbds_codebias_cor(t_gsetbase* settings);
 		virtual ~t_gbds_codebias_cor() {};
 
-		void apply_IGSO_MEO(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata);
-		void apply_IGSO_MEO_obs(t_gtriple& rec_crd, t_gallnav* gnav, const shared_ptr<t_gobsgnss>& obsdata);
-		void apply_IGSO_MEO_ele(const double& elev, t_gsatdata& obsdata);
+		/**
+		 * @brief correct the BDS-2 IGSO/MEO code of one station
+		 * @note read only apart from rec_crd and obsdata, thread safe for different stations
+		 */
+		void apply_IGSO_MEO(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata) const;
+		void apply_IGSO_MEO_obs(t_gtriple& rec_crd, t_gallnav* gnav, const shared_ptr<t_gobsgnss>& obsdata) const;
+		void apply_IGSO_MEO_ele(const double& elev, t_gsatdata& obsdata) const;
 
 	private:
 
@@ -85,11 +115,16 @@ namespace great
 		map< GSYS, map<FREQ_SEQ, GOBSBAND> > _band_index;
 		bool                                 _correct_bds_code_bias;
 		// Wanninger & Beer : BeiDou satellite-induced code pseudorange variations: diagnosis and therapy [unit:m]
-		map<GOBSBAND, map<string, map<int, double> > > _IGSO_MEO_Corr;
+		// [B1/B2/B3][IGSO/MEO][elevation 0-90 deg in steps of 10 deg]
+		double _IGSO_MEO_Corr[3][2][10];
 		/**
 		 * @brief Approximate location of the receiver
 		 */
-		bool _recAprCoordinate(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata);
+		bool _recAprCoordinate(const string& rec, t_gtriple& rec_crd, t_gallnav* gnav, vector<t_gsatdata>& obsdata) const;
+		/**
+		 * @brief correct the code of one satellite with the elevation [deg]
+		 */
+		void _correct(const string& sat, double elev, t_gobsgnss& obsdata) const;
 
 	};
 
@@ -125,6 +160,15 @@ namespace great
 		virtual ~t_gqualitycontrol();
 
 		int processOneEpoch(const t_gtime& now, const string& rec, t_gtriple& rec_crd, vector<t_gsatdata>& obsdata);
+		/**
+		 * @brief process one epoch of one station with its own state
+		 * @note thread safe for different stations, the states are got by site_state before
+		 */
+		int processOneEpoch(const t_gtime& now, const string& rec, t_gtriple& rec_crd, vector<t_gsatdata>& obsdata, t_gqcstate& state) const;
+		/**
+		 * @brief state of the station, added if new (not thread safe)
+		 */
+		t_gqcstate& site_state(const string& rec) { return _site_state[rec]; };
 		void bds_code_bias(t_gtriple& rec_crd, const shared_ptr<t_gobsgnss>& obsdata);
 		void setNav(t_gallnav* gnav) { _gnav = gnav; };
 
@@ -137,6 +181,7 @@ namespace great
 		t_gbds_codebias_cor   _bds_codebias_cor; ///< bds codebias correction
 		t_gsmooth             _smooth_range;     ///< smooth range
 		t_goutliers_process   _outliers_proc;    ///< outliers process
+		map<string, t_gqcstate> _site_state;     ///< state of each station
 
 
 	};
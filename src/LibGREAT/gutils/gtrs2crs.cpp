@@ -87,6 +87,8 @@ namespace great
 		_xpole = Other._xpole;
 		_ypole = Other._ypole;
 		_gmst = Other._gmst;
+		_gast = Other._gast;
+		_sp = Other._sp;
 		_rotmat = Other._rotmat;
 		_rotdu = Other._rotdu;
 		_rotdx = Other._rotdx;
@@ -116,12 +118,14 @@ namespace great
 	double t_gtrs2crs::getXpole() { return _xpole; };  
 	double t_gtrs2crs::getYpole() { return _ypole; }; 
 	double t_gtrs2crs::getGmst() { return _gmst; };
+	double t_gtrs2crs::getGast() { return _gast; };
+	double t_gtrs2crs::getSp() { return _sp; };
+	Matrix& t_gtrs2crs::getQMat() { return _qmat; };
 	t_gtime t_gtrs2crs::getCurtEpoch() { return _tdt; };
 
 	//main
 	void t_gtrs2crs::calcRotMat(const t_gtime& epoch, const bool& ldxdpole, const bool& ldydpole, const bool& ldudpole)
 	{
-		const double dRr = 1.00273781191135448;
 		double era;           //earth rotation angle in radian
 		double sp;
 		double psi, eps, gast;
@@ -157,13 +161,6 @@ namespace great
 
 		sp = _sp2000(_tdt.mjd(), (_tdt.sod()+ _tdt.dsec()) / 86400.0);
 
-		vector<Matrix> roty;
-		calcProcMat(ldydpole, 1, _ypole,roty);
-		vector<Matrix> rotx;
-		calcProcMat(ldxdpole, 2, _xpole,rotx);
-		vector<Matrix> rotsp;
-		calcProcMat(false, 3, -sp, rotsp);
-
 		era = _era2000(sTUT1.mjd()*1.0, (sTUT1.sod()+sTUT1.dsec()) / 86400.0);
 
 		_nutInt(_tdt.dmjd(), &psi, &eps, 0.0625);
@@ -181,6 +178,35 @@ namespace great
 			gast = _gst2006(sTUT1.mjd()*1.0, (sTUT1.sod() + sTUT1.dsec()) / 86400.0, _tdt.mjd()*1.0, (_tdt.sod() + _tdt.dsec()) / 86400.0);
 		}
 
+		_composeRotMat(sp, gast, ldxdpole, ldydpole, ldudpole);
+	}
+
+	void t_gtrs2crs::setRotMat(const t_gtime& epoch, const Matrix& qmat, const double& gast, const double& gmst, const double& sp,
+		const double& xpole, const double& ypole, const bool& ldxdpole, const bool& ldydpole, const bool& ldudpole)
+	{
+		_tdt = epoch;
+		_qmat = qmat;
+		_gmst = gmst;
+		_xpole = xpole;
+		_ypole = ypole;
+
+		_composeRotMat(sp, gast, ldxdpole, ldydpole, ldudpole);
+	}
+
+	void t_gtrs2crs::_composeRotMat(const double& sp, const double& gast, const bool& ldxdpole, const bool& ldydpole, const bool& ldudpole)
+	{
+		const double dRr = 1.00273781191135448;
+
+		_gast = gast;
+		_sp = sp;
+
+		vector<Matrix> roty;
+		calcProcMat(ldydpole, 1, _ypole,roty);
+		vector<Matrix> rotx;
+		calcProcMat(ldxdpole, 2, _xpole,rotx);
+		vector<Matrix> rotsp;
+		calcProcMat(false, 3, -sp, rotsp);
+
 		vector<Matrix> rotu;
 		calcProcMat(ldudpole, 3, -gast,rotu);
 		Matrix mathlp;
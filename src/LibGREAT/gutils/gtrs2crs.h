@@ -110,6 +110,13 @@ namespace great
 		/** @brief calculate the rotation matrix. */
 		void calcRotMat(const t_gtime& epoch, const bool& ldxdpole, const bool& ldydpole, const bool& ldudpole);
 
+		/**
+		* @brief set the rotation matrix from the precession-nutation matrix and the angles (radian),
+		*        the IAU series are skipped
+		*/
+		void setRotMat(const t_gtime& epoch, const Matrix& qmat, const double& gast, const double& gmst, const double& sp,
+			const double& xpole, const double& ypole, const bool& ldxdpole, const bool& ldydpole, const bool& ldudpole);
+
 		/** @brief return rotation matrix. */
 		Matrix& getRotMat();
 
@@ -128,10 +135,19 @@ namespace great
 		double getYpole();
 		/** @brief return gmst. */
 		double getGmst();
+		/** @brief return gast. */
+		double getGast();
+		/** @brief return the angle s' of the TIO locator. */
+		double getSp();
+		/** @brief return precession-nutation matrix. */
+		Matrix& getQMat();
 		/** @brief return now epoch. */
 		t_gtime getCurtEpoch();
 
 	protected:
+		/** @brief compose the rotation matrix and its partials from _qmat, _xpole, _ypole (radian), gast and sp. */
+		void	 _composeRotMat(const double& sp, const double& gast, const bool& ldxdpole, const bool& ldydpole, const bool& ldudpole);
+
 		/** @brief interpolate short term tidal corrections(fortran: polut1_ray_interpolation). */
 		void	 _tide_corrections(t_gtime& t, t_gtriple& xyu);
 
@@ -225,6 +241,8 @@ namespace great
 		double    _xpole;     ///< x pole of pole shift
 		double    _ypole;     ///< y pole of pole shift
 		double    _gmst;      ///< Greenwich Mean Sidereal Time
+		double    _gast = 0.0; ///< Greenwich Apparent Sidereal Time
+		double    _sp = 0.0;  ///< TIO locator s'
 		Matrix    _rotmat;    ///< rotation matrix from TRS to CRS
 		Matrix    _rotdu;     ///< partial of rotmat wrt to ut1.
 		Matrix    _rotdx;     ///< partial of rotmat wrt to xpole
@@ -0,0 +1,295 @@
+/**
+ * @file         gtrs2crstable.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        precomputed TRS2CRS angles on a regular grid, shared by all threads
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gutils/gtrs2crstable.h"
+#include "gutils/gconst.h"
+
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace great
+{
+	t_gtrs2crs_table::t_gtrs2crs_table(t_gpoleut1* erp, double accuracy, int num_point) :
+		_erp(erp),
+		_accuracy(accuracy),
+		_num_point(min(max(num_point, 2), MAX_POINT))
+	{
+	}
+
+	t_gtrs2crs_table::~t_gtrs2crs_table()
+	{
+	}
+
+	bool t_gtrs2crs_table::build(const t_gtime& beg, const t_gtime& end)
+	{
+		_val.clear();
+		_valid.clear();
+		_max_err = 0.0;
+		if (!_erp || _erp->isEmpty() || end < beg) return false;
+
+		_beg = beg;
+		_beg.tsys(t_gtime::TT);
+		_end = end;
+		_end.tsys(t_gtime::TT);
+		_erp_beg = _erp->getPoleUt1DataMap()->begin()->first;
+		_erp_end = _erp->getPoleUt1DataMap()->rbegin()->first;
+
+		// hourly nodes, halved while the accuracy improves
+		double step = 3600.0;
+		if (!_build(step)) return false;
+		_max_err = _check();
+
+		while (_max_err > _accuracy && step / 2.0 >= 60.0)
+		{
+			step /= 2.0;
+			double max_err_prev = _max_err;
+			if (!_build(step)) return false;
+			_max_err = _check();
+
+			// limited by the direct computation itself, e.g. the piecewise tidal ERP
+			if (_max_err > 0.5 * max_err_prev) break;
+		}
+
+		// the accuracy target not met, the rotations are computed directly
+		return _max_err <= _accuracy;
+	}
+
+	bool t_gtrs2crs_table::interpolate(const t_gtime& tdt, t_gtrs2crs& trs2crs) const
+	{
+		int num = size();
+		if (num == 0) return false;
+
+		t_gtime t = tdt;
+		t.tsys(t_gtime::TT);
+		double day_sec = (t.mjd() - _mjd0) * 86400.0;
+		double x = (day_sec + t.sod() + t.dsec() - _sec0) / _step;
+		if (x < 0.0 || x > num - 1) return false;
+
+		// nodes of the TT day of t, both midnights included
+		int day_beg = max(0, (int)ceil((day_sec - _sec0) / _step - 1e-9));
+		int day_end = min(num - 1, (int)floor((day_sec + 86400.0 - _sec0) / _step + 1e-9));
+		if (day_end - day_beg + 1 < _num_point) return false;
+
+		int first = (int)floor(x) - _num_point / 2 + 1;
+		first = max(first, day_beg);
+		first = min(first, day_end - _num_point + 1);
+
+		// Lagrange weights on the equally spaced nodes
+		double u = x - first;
+		double w[MAX_POINT];
+		for (int j = 0; j < _num_point; j++)
+		{
+			if (!_valid[first + j]) return false;
+			w[j] = 1.0;
+			for (int m = 0; m < _num_point; m++)
+			{
+				if (m != j) w[j] *= (u - m) / (j - m);
+			}
+		}
+
+		double val[NUM_VAL] = { 0.0 };
+		for (int j = 0; j < _num_point; j++)
+		{
+			const double* node = &_val[(size_t)(first + j) * NUM_VAL];
+			for (int k = 0; k < NUM_VAL; k++)
+			{
+				val[k] += w[j] * node[k];
+			}
+		}
+
+		Matrix qmat(3, 3);
+		for (int r = 0; r < 3; r++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				qmat(r + 1, c + 1) = val[3 * r + c];
+			}
+		}
+		trs2crs.setRotMat(t, qmat, val[9], val[10], val[11], val[12], val[13], true, true, true);
+
+		return true;
+	}
+
+	void t_gtrs2crs_table::benchmark(int num, double& direct_us, double& table_us, double& max_err) const
+	{
+		direct_us = 0.0;
+		table_us = 0.0;
+		max_err = 0.0;
+		if (size() == 0 || num <= 0) return;
+
+		double span = _end.diff(_beg);
+		vector<t_gtime> epochs;
+		for (int i = 0; i < num; i++)
+		{
+			epochs.push_back(_beg + span * (i + 0.37) / num);
+		}
+
+		vector<Matrix> rot_direct(num), rot_table(num);
+		vector<char> valid_direct(num, 0), valid_table(num, 0);
+
+		auto beg_time = chrono::high_resolution_clock::now();
+		for (int i = 0; i < num; i++)
+		{
+			try
+			{
+				t_gtrs2crs trs2crs(false, _erp);
+				trs2crs.calcRotMat(epochs[i], true, true, true);
+				rot_direct[i] = trs2crs.getRotMat();
+				valid_direct[i] = 1;
+			}
+			catch (...)
+			{
+			}
+		}
+		auto mid_time = chrono::high_resolution_clock::now();
+		for (int i = 0; i < num; i++)
+		{
+			t_gtrs2crs trs2crs(false, _erp);
+			if (interpolate(epochs[i], trs2crs))
+			{
+				rot_table[i] = trs2crs.getRotMat();
+				valid_table[i] = 1;
+			}
+		}
+		auto end_time = chrono::high_resolution_clock::now();
+
+		direct_us = chrono::duration<double, micro>(mid_time - beg_time).count() / num;
+		table_us = chrono::duration<double, micro>(end_time - mid_time).count() / num;
+
+		for (int i = 0; i < num; i++)
+		{
+			if (!valid_direct[i] || !valid_table[i]) continue;
+			max_err = max(max_err, (rot_table[i] - rot_direct[i]).maximum_absolute_value());
+		}
+	}
+
+	bool t_gtrs2crs_table::_build(double step)
+	{
+		_step = step;
+		_mjd0 = _beg.mjd();
+
+		// enough nodes around beg/end, also if they are close to a midnight
+		double margin = _num_point * step;
+		double beg_sec = _beg.sod() + _beg.dsec() - margin;
+		double end_sec = (_end.mjd() - _mjd0) * 86400.0 + _end.sod() + _end.dsec() + margin;
+		_sec0 = floor(beg_sec / step) * step;
+		int num = (int)ceil((end_sec - _sec0) / step) + 1;
+
+		_val.assign((size_t)num * NUM_VAL, 0.0);
+		_valid.assign(num, 0);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int i = 0; i < num; i++)
+		{
+			_valid[i] = _compute_node(_tt_time(_sec0 + i * step), &_val[(size_t)i * NUM_VAL]);
+		}
+
+		// GAST and GMST continuous over the nodes
+		int prev = -1;
+		for (int i = 0; i < num; i++)
+		{
+			if (!_valid[i]) continue;
+			if (prev >= 0)
+			{
+				for (int k = 9; k <= 10; k++)
+				{
+					double pred = _val[(size_t)prev * NUM_VAL + k] + OMGE_DOT_GAL * step * (i - prev);
+					double& angle = _val[(size_t)i * NUM_VAL + k];
+					angle += 2.0 * G_PI * floor((pred - angle) / (2.0 * G_PI) + 0.5);
+				}
+			}
+			prev = i;
+		}
+
+		return prev >= 0;
+	}
+
+	double t_gtrs2crs_table::_check() const
+	{
+		int num = size();
+		int num_check = min(num - 1, 48);
+		if (num_check <= 0) return 0.0;
+
+		vector<double> err(num_check, 0.0);
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int i = 0; i < num_check; i++)
+		{
+			int k = (int)((i + 0.5) * (num - 1) / num_check);
+			t_gtime t = _tt_time(_sec0 + (k + 0.5) * _step);
+
+			t_gtrs2crs table(false, _erp);
+			if (!interpolate(t, table)) continue;
+			try
+			{
+				t_gtrs2crs direct(false, _erp);
+				direct.calcRotMat(t, true, true, true);
+				err[i] = (table.getRotMat() - direct.getRotMat()).maximum_absolute_value();
+			}
+			catch (...)
+			{
+			}
+		}
+
+		return *max_element(err.begin(), err.end());
+	}
+
+	bool t_gtrs2crs_table::_compute_node(const t_gtime& tdt, double* val) const
+	{
+		// ERP records of both midnights, see t_gtrs2crs::_calPoleut1
+		t_gtime day(t_gtime::TT);
+		day.from_mjd(tdt.mjd(), 0, 0.0);
+		if (day < _erp_beg || day + 86400.0 > _erp_end) return false;
+
+		try
+		{
+			t_gtrs2crs trs2crs(false, _erp);
+			trs2crs.calcRotMat(tdt, true, true, true);
+
+			const Matrix& qmat = trs2crs.getQMat();
+			for (int r = 0; r < 3; r++)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					val[3 * r + c] = qmat(r + 1, c + 1);
+				}
+			}
+			val[9] = trs2crs.getGast();
+			val[10] = trs2crs.getGmst();
+			val[11] = trs2crs.getSp();
+			val[12] = trs2crs.getXpole() / RAD2SEC;
+			val[13] = trs2crs.getYpole() / RAD2SEC;
+		}
+		catch (...)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	t_gtime t_gtrs2crs_table::_tt_time(double sec) const
+	{
+		int day = (int)floor(sec / 86400.0);
+		double sod = sec - day * 86400.0;
+
+		t_gtime t(t_gtime::TT);
+		t.from_mjd(_mjd0 + day, (int)sod, sod - (int)sod);
+		return t;
+	}
+}
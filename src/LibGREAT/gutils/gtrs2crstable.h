@@ -0,0 +1,110 @@
+/**
+ * @file         gtrs2crstable.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        precomputed TRS2CRS angles on a regular grid, shared by all threads
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GTRS2CRSTABLE_H
+#define GTRS2CRSTABLE_H
+
+#include "gexport/ExportLibGREAT.h"
+#include "gutils/gtrs2crs.h"
+#include "gutils/gtime.h"
+#include "gdata/gpoleut1.h"
+
+#include <vector>
+
+using namespace std;
+using namespace gnut;
+
+namespace great
+{
+	/**
+	* @brief table of the precession-nutation matrix, GAST, GMST, s', xpole and ypole
+	*        on a regular TT grid, rotations are served by Lagrange interpolation
+	* @note the nodes are computed by t_gtrs2crs::calcRotMat as t_gprecisemodel::_update_rot_matrix does.
+	*       The ERP are linear within a day, so the interpolation never uses nodes of another TT day.
+	*       The table is read only after build, interpolate may be called by any thread.
+	*/
+	class LibGREAT_LIBRARY_EXPORT t_gtrs2crs_table
+	{
+	public:
+		/**
+		* @brief constructor
+		* @param[in] erp poleut1 data
+		* @param[in] accuracy max difference of the rotation matrix elements to the direct computation [rad]
+		* @param[in] num_point number of nodes for the interpolation
+		*/
+		t_gtrs2crs_table(t_gpoleut1* erp, double accuracy = 1e-11, int num_point = 8);
+
+		/** @brief default destructor */
+		~t_gtrs2crs_table();
+
+		/**
+		* @brief build the table for [beg, end], in parallel over the nodes
+		* @note the step is halved from 3600 s until the accuracy is met at the interval midpoints
+		*       or does not improve any more
+		* @return false if no node could be computed or the accuracy is not met
+		*/
+		bool build(const t_gtime& beg, const t_gtime& end);
+
+		/**
+		* @brief set the rotation and its partials at tdt (TT) in trs2crs
+		* @return false if tdt is out of the table, the caller computes it directly
+		*/
+		bool interpolate(const t_gtime& tdt, t_gtrs2crs& trs2crs) const;
+
+		/** @brief step of the nodes [s] */
+		double step() const { return _step; }
+
+		/** @brief number of the nodes */
+		int size() const { return (int)_valid.size(); }
+
+		/** @brief max difference to the direct computation at the interval midpoints [rad] */
+		double max_err() const { return _max_err; }
+
+		/**
+		* @brief compare the interpolation with the direct computation at num epochs of the table
+		* @param[out] direct_us time of one direct rotation [us]
+		* @param[out] table_us  time of one interpolated rotation [us]
+		* @param[out] max_err   max difference of the rotation matrix elements [rad]
+		*/
+		void benchmark(int num, double& direct_us, double& table_us, double& max_err) const;
+
+	private:
+		static const int NUM_VAL = 14;   ///< qmat(9), gast, gmst, sp, xpole, ypole
+		static const int MAX_POINT = 16; ///< max number of nodes for the interpolation
+
+		/** @brief build the nodes with step */
+		bool _build(double step);
+
+		/** @brief max difference to the direct computation at the interval midpoints */
+		double _check() const;
+
+		/** @brief values of one node, false if the ERP are missing */
+		bool _compute_node(const t_gtime& tdt, double* val) const;
+
+		/** @brief TT epoch of the seconds after the first day */
+		t_gtime _tt_time(double sec) const;
+
+		t_gpoleut1* _erp;          ///< poleut1 data
+		double _accuracy;          ///< accuracy target [rad]
+		int    _num_point;         ///< number of nodes for the interpolation
+		t_gtime _beg;              ///< begin of the request
+		t_gtime _end;              ///< end of the request
+		t_gtime _erp_beg;          ///< first ERP record
+		t_gtime _erp_end;          ///< last ERP record
+		int    _mjd0 = 0;          ///< first TT day
+		double _sec0 = 0.0;        ///< first node [s after _mjd0]
+		double _step = 0.0;        ///< step of the nodes [s]
+		double _max_err = 0.0;     ///< max difference at the interval midpoints [rad]
+		vector<double> _val;       ///< NUM_VAL values per node
+		vector<char>   _valid;     ///< node computed
+	};
+}
+
+#endif // !GTRS2CRSTABLE_H
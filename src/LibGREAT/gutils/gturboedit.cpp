@@ -28,6 +28,12 @@
 #include <set>
 #include "gio/gfile.h"
 #include "gcoders/ambflag.h"
+#include "gset/gsetgnss.h"
+#include "gutils/gconst.h"
+
+#ifdef USE_OPENMP
+	#include <omp.h>
+#endif
 
 #ifdef WIN32
 	#include <io.h>
@@ -431,5 +437,273 @@ namespace great
 		}
 
 	}
-}
 
+	int great::t_gturboedit::edit(t_gallobs* allobs, const set<string>& sites, const t_gtime& beg, const t_gtime& end, double intv)
+	{
+		if (!allobs || intv <= 0.0 || end < beg) return 0;
+		if (!_gambflag) _gambflag = make_shared<t_gallambflag>(t_gdata::AMBFLAG);
+
+		// settings read once before the sites are edited in parallel
+		t_gsetturboedit* set_tb = dynamic_cast<t_gsetturboedit*>(_gset);
+		double gf_rms_limit = 0.0;
+		_edit_check_mw = set_tb->checkMW(_edit_mw_limit);
+		_edit_check_gf = set_tb->checkGF(_edit_gf_limit, gf_rms_limit);
+		_edit_check_gap = set_tb->checkGap(_edit_gap_limit);
+		_edit_check_short = set_tb->checkShort(_edit_short_limit);
+
+		_edit_bands.clear();
+		for (GSYS gsys : { GPS, GAL, GLO, BDS, QZS })
+		{
+			map<FREQ_SEQ, GOBSBAND> band_index = dynamic_cast<t_gsetgnss*>(_gset)->band_index(gsys);
+			if (band_index.count(FREQ_1) == 0 || band_index.count(FREQ_2) == 0) continue;
+			_edit_bands[gsys] = make_pair(band_index[FREQ_1], band_index[FREQ_2]);
+		}
+
+		// sites with log files are kept
+		vector<string> edit_sites;
+		for (const auto& site : sites)
+		{
+			if (!_amb_info_file_exist[site]) edit_sites.push_back(site);
+		}
+
+		vector<t_gambflag> ambflags(edit_sites.size());
+		vector<int> edited(edit_sites.size(), 0);
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int i = 0; i < (int)edit_sites.size(); i++)
+		{
+			edited[i] = _edit_site(allobs, edit_sites[i], beg, end, intv, ambflags[i]) ? 1 : 0;
+		}
+
+		// arcs added as if read from the log files
+		bool amb_output = set_tb->isAmbOutput();
+		int nsite = 0;
+		for (size_t i = 0; i < edit_sites.size(); i++)
+		{
+			if (!edited[i]) continue;
+
+			const string& site = edit_sites[i];
+			string lower_site(site);
+			transform(site.begin(), site.end(), lower_site.begin(), ::tolower);
+
+			t_gambflag& ambflag = ambflags[i];
+			for (const auto& sat_arcs : ambflag.getAmbFlagData())
+			{
+				for (const auto& arc : sat_arcs.second)
+				{
+					add_ambflag(site, sat_arcs.first, arc->identify, ambflag.epoch2time(arc->beg_epo), ambflag.epoch2time(arc->end_epo));
+				}
+			}
+			_active_amb[site] = ambflag.getAmbFlagHead()->max_amb_1epo;
+			_amb_info_file_exist[site] = true;
+			_gambflag->addAmbFlag(lower_site, ambflag);
+
+			if (amb_output) _write_logfile(site, ambflag, beg);
+			nsite++;
+		}
+
+		return nsite;
+	}
+
+	bool great::t_gturboedit::_edit_site(t_gallobs* allobs, const string& site, const t_gtime& beg, const t_gtime& end, double intv, t_gambflag& ambflag) const
+	{
+		// MW and GF of all satellites
+		map<string, vector<t_gtbobs> > sat_series;
+		vector<t_gtime> epochs = allobs->epochs(site);
+		for (const auto& epoch : epochs)
+		{
+			if (epoch < beg || epoch > end) continue;
+			int epo = (int)floor((epoch - beg) / intv + 0.5) + 1;
+
+			vector<t_spt_gobs> all_obs = allobs->obs_pt(site, epoch);
+			for (const auto& obs : all_obs)
+			{
+				GSYS gsys = obs->gsys();
+				auto itBAND = _edit_bands.find(gsys);
+				if (itBAND == _edit_bands.end()) continue;
+				if (gsys == GLO && obs->channel() == DEF_CHANNEL) continue;
+
+				GOBSBAND b1 = itBAND->second.first;
+				GOBSBAND b2 = itBAND->second.second;
+				GOBS gL1 = obs->select_phase(b1), gL2 = obs->select_phase(b2);
+				GOBS gP1 = obs->select_range(b1), gP2 = obs->select_range(b2);
+				if (gL1 == X || gL2 == X || gP1 == X || gP2 == X) continue;
+
+				double L1 = obs->obs_L(t_gobs(gL1));
+				double L2 = obs->obs_L(t_gobs(gL2));
+				double P1 = obs->obs_C(t_gobs(gP1));
+				double P2 = obs->obs_C(t_gobs(gP2));
+				if (double_eq(L1, NULL_GOBS) || double_eq(L2, NULL_GOBS) ||
+					double_eq(P1, NULL_GOBS) || double_eq(P2, NULL_GOBS)) continue;
+
+				double f1 = obs->frequency(b1);
+				double f2 = obs->frequency(b2);
+				if (f1 <= 0.0 || f2 <= 0.0 || double_eq(f1, f2)) continue;
+
+				t_gtbobs one;
+				one.epo = epo;
+				one.mw = (f1 * L1 - f2 * L2) / CLIGHT - (f1 - f2) * (f1 * P1 + f2 * P2) / ((f1 + f2) * CLIGHT);
+				one.gf = (L1 - L2) / (CLIGHT / f2 - CLIGHT / f1);
+				one.lli = ((obs->getlli(gL1) | obs->getlli(gL2)) & 1) != 0;
+				sat_series[obs->sat()].push_back(one);
+			}
+		}
+		if (sat_series.empty()) return false;
+
+		int nepo = (int)floor((end - beg) / intv + 0.5) + 1;
+		vector<int> active(nepo + 2, 0);
+		int new_amb = 0, rm_obs = 0, avail_obs = 0;
+
+		for (const auto& itSAT : sat_series)
+		{
+			const vector<t_gtbobs>& series = itSAT.second;
+			vector<ambflag_data> arcs;
+			string reason = "NEW";
+
+			size_t i = 0;
+			while (i < series.size())
+			{
+				// the arc is followed while MW stays around its mean and GF along the last two epochs
+				size_t last = i, prev = series.size();
+				int    nobs = 1;
+				double mean = series[i].mw, m2 = 0.0;
+				vector<int> outliers;
+
+				auto jump = [&](size_t k) -> string
+				{
+					if (_edit_check_mw && fabs(series[k].mw - mean) > _edit_mw_limit) return "MW";
+					if (_edit_check_gf)
+					{
+						double gf_pred = series[last].gf;
+						if (prev < series.size())
+						{
+							gf_pred += (series[last].gf - series[prev].gf) * (series[k].epo - series[last].epo) / double(series[last].epo - series[prev].epo);
+						}
+						if (fabs(series[k].gf - gf_pred) > _edit_gf_limit) return "GF";
+					}
+					return "";
+				};
+				auto broken = [&](size_t k) -> string
+				{
+					if (_edit_check_gap && series[k].epo - series[last].epo > _edit_gap_limit) return "GAP";
+					if (series[k].lli) return "LLI";
+					return jump(k);
+				};
+
+				size_t j = i + 1;
+				string next_reason;
+				for (; j < series.size(); j++)
+				{
+					next_reason = broken(j);
+					if (!next_reason.empty())
+					{
+						// single outlier if the arc continues after it
+						if (next_reason != "GAP" && next_reason != "LLI" && j + 1 < series.size() && broken(j + 1).empty())
+						{
+							outliers.push_back(series[j].epo);
+							continue;
+						}
+						break;
+					}
+
+					prev = last;
+					last = j;
+					nobs++;
+					double delta = series[j].mw - mean;
+					mean += delta / nobs;
+					m2 += delta * (series[j].mw - mean);
+				}
+
+				ambflag_data arc;
+				bool valid = !_edit_check_short || nobs >= _edit_short_limit;
+				arc.identify = valid ? "AMB" : "DEL";
+				arc.beg_epo = series[i].epo;
+				arc.end_epo = series[last].epo;
+				arc.iflag = valid ? "1" : "0";
+				arc.C1 = mean;
+				arc.C2 = (nobs > 1) ? sqrt(m2 / (nobs - 1)) : 0.0;
+				arc.reason = valid ? reason : "SHORT";
+				arcs.push_back(arc);
+
+				for (int epo : outliers)
+				{
+					ambflag_data del;
+					del.identify = "DEL";
+					del.beg_epo = epo;
+					del.end_epo = epo;
+					del.iflag = "0";
+					del.reason = "OUTLIER";
+					arcs.push_back(del);
+				}
+
+				if (valid)
+				{
+					new_amb++;
+					avail_obs += nobs;
+					if (arc.beg_epo >= 1 && arc.end_epo <= nepo)
+					{
+						active[arc.beg_epo]++;
+						active[arc.end_epo + 1]--;
+					}
+				}
+				else rm_obs += nobs;
+				rm_obs += (int)outliers.size();
+
+				reason = next_reason;
+				i = j;
+			}
+
+			stable_sort(arcs.begin(), arcs.end(), [](const ambflag_data& a, const ambflag_data& b) { return a.beg_epo < b.beg_epo; });
+			for (const auto& arc : arcs) ambflag.addAmbFlagData(itSAT.first, arc);
+		}
+
+		ambflag_hd head;
+		head.beg_mjd = beg.mjd();
+		head.beg_sod = beg.sod() + beg.dsec();
+		head.duration = (int)(nepo * intv);
+		head.intv = intv;
+		head.new_rm_obs = rm_obs;
+		head.new_amb = new_amb;
+		head.avaiable_obs = avail_obs;
+		head.rec_name = site;
+		for (int k = 1, num = 0; k <= nepo; k++)
+		{
+			num += active[k];
+			head.max_amb_1epo = max(head.max_amb_1epo, num);
+		}
+
+		string lower_site(site);
+		transform(site.begin(), site.end(), lower_site.begin(), ::tolower);
+		ambflag.setSite(lower_site);
+		ambflag.setAmbFlagHead(head);
+
+		return true;
+	}
+
+	void great::t_gturboedit::_write_logfile(const string& site, t_gambflag& ambflag, const t_gtime& beg)
+	{
+		// named as expected by _read_logfile
+		string site_low(site);
+		transform(site.begin(), site.end(), site_low.begin(), ::tolower);
+		site_low = site_low.substr(0, 4);
+
+		stringstream log_name;
+		log_name << "log_tb/" << site_low << setw(3) << setfill('0') << beg.doy() << "0."
+			<< setw(2) << setfill('0') << beg.yr() << "o.log";
+		if (_index > 2) log_name << "1" << _index;
+
+		t_gallambflag allambflag(t_gdata::AMBFLAG);
+		allambflag.addAmbFlag(site_low, ambflag);
+
+		t_gfile gout;
+		gout.glog(_log);
+		gout.path(log_name.str());
+
+		t_ambflag ambflag_coder(_gset, "", 4096);
+		ambflag_coder.path(log_name.str());
+		ambflag_coder.add_data("ID0", &allambflag);
+		gout.coder(&ambflag_coder);
+		gout.run_write();
+	}
+}
@@ -24,6 +24,7 @@
 #include "gutils/gcycleslip.h"
 #include "gdata/gsatdata.h"
 #include "gall/gallambflag.h"
+#include "gall/gallobs.h"
 #include "gset/gsetturboedit.h"
 #include "gexport/ExportLibGREAT.h"
 
@@ -69,7 +70,35 @@ namespace great
 		map<string, bool>& logfile_exist() { return _amb_info_file_exist; }
 		void merge_logfile_exist(const map<string, bool>& logfile);
 
+		/**
+		* @brief in-process TurboEdit of the sites without log file
+		* @note  MW and GF slips, outliers, gaps and short arcs over the whole arcs of each site,
+		*        the sites are edited in parallel, the arcs are kept as read from the log files
+		* @param[in]  allobs	observations of all sites.
+		* @param[in]  sites		sites to be edited.
+		* @param[in]  beg		begin of the processing.
+		* @param[in]  end		end of the processing.
+		* @param[in]  intv		sampling interval [s].
+		* @return	  number of sites edited
+		*/
+		int edit(t_gallobs* allobs, const set<string>& sites, const t_gtime& beg, const t_gtime& end, double intv);
+
 	protected:
+		/** @brief MW [cycle] and GF [cycle of lambda2 - lambda1] of one satellite in one epoch */
+		struct t_gtbobs
+		{
+			int    epo;      ///< epoch index (from 1)
+			double mw;       ///< Melbourne-Wuebbena combination
+			double gf;       ///< geometry-free combination
+			bool   lli;      ///< loss of lock
+		};
+
+		/** @brief edit all satellite arcs of one site */
+		bool _edit_site(t_gallobs* allobs, const string& site, const t_gtime& beg, const t_gtime& end, double intv, t_gambflag& ambflag) const;
+
+		/** @brief write the arcs of one site to the log file (log_tb) */
+		void _write_logfile(const string& site, t_gambflag& ambflag, const t_gtime& beg);
+
 		/** @brief read log file and record cycle slip info*/
 		void _read_logfie(const set<string>& rec, const t_gtime& epoch, int index);
 		void _read_logfile(const set<string>& rec, const t_gtime& epoch, int index);
@@ -86,6 +115,16 @@ namespace great
 
 		int  _index = -1;
 		bool _apply_carrier_range = false;
+
+		map<GSYS, pair<GOBSBAND, GOBSBAND> > _edit_bands;	///< bands of the dual-frequency combinations
+		bool   _edit_check_mw = true;						///< MW slips
+		bool   _edit_check_gf = true;						///< GF slips
+		bool   _edit_check_gap = true;						///< gaps break the arcs
+		bool   _edit_check_short = true;					///< short arcs removed
+		double _edit_mw_limit = 4.0;						///< MW limit [cycle]
+		double _edit_gf_limit = 1.0;						///< GF limit [cycle]
+		int    _edit_gap_limit = 20;						///< gap limit [epoch]
+		int    _edit_short_limit = 10;						///< short arc limit [epoch]
 	};
 }
 
@@ -231,6 +231,33 @@ vector<t_gsatdata> t_gallobs::obs(const set<string>& sites, const t_gtime& t)
 }
 
 
+// get pointers of the obs of all sites for epoch t
+// ----------
+void t_gallobs::obs_view(const set<string>& sites, const t_gtime& t, t_gobsview& view)
+{
+  gtrace("t_gallobs::obs_view");
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+
+  view.sites.assign(sites.begin(), sites.end());
+  view.beg.clear();
+  view.obs.clear();
+  t_gtime tt(t_gtime::GPS);
+  for (const auto& site : view.sites) {
+    view.beg.push_back(view.obs.size());
+    if (_find_epo(site, t, tt) < 0) continue;
+    for (auto& itSAT : _mapobj[site][tt]) {
+      view.obs.push_back(itSAT.second.get());
+    }
+  }
+  view.beg.push_back(view.obs.size());
+
+  _gmutex.unlock();
+}
+
 // protected
 // ---------
 vector<t_gsatdata> t_gallobs::_gobs(const string& site,
@@ -429,13 +456,202 @@ int t_gallobs::end_obs_sites(const t_gtime& t, const set<string>& sites)
     return count;
 }
 
+// copy observations into the columnar store
+// ----------
+// add site apriori coordinates (headers decoded concurrently)
+// ----------
+void t_gallobs::addsitecrd(string site, t_gtriple crd)
+{
+  gtrace("t_gallobs::addsitecrd");
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+  _mapcrds[site] = crd;
+  _gmutex.unlock();
+}
+
+// get site apriori coordinates
+// ----------
+t_gtriple t_gallobs::getsitecrd(string site)
+{
+  gtrace("t_gallobs::getsitecrd");
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+  t_gtriple crd = _mapcrds[site];
+  _gmutex.unlock();
+  return crd;
+}
+
+// get GLONASS frequency numbers
+// ----------
+map<string, int> t_gallobs::glo_freq_num()
+{
+  gtrace("t_gallobs::glo_freq_num");
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+  map<string, int> tmp = _glofrq;
+  _gmutex.unlock();
+  return tmp;
+}
+
+// add GLONASS frequency number (first one kept, headers decoded concurrently)
+// ----------
+void t_gallobs::add_glo_freq(string sat, int freqNum)
+{
+  gtrace("t_gallobs::add_glo_freq");
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+  if (_glofrq.find(sat) == _glofrq.end()) _glofrq[sat] = freqNum;
+  _gmutex.unlock();
+}
+
+void t_gallobs::compact(t_gobsstore& store, const set<string>& sites, bool release)
+{
+  gtrace("t_gallobs::compact");
+
+  _gmutex.lock();
+
+  vector<t_gobsgnss*> vec_obs;
+  for (auto& itSITE : _mapobj) {
+    if (!sites.empty() && sites.find(itSITE.first) == sites.end()) continue;
+    for (auto& itEPO : itSITE.second) {
+      vec_obs.clear();
+      for (auto& itSAT : itEPO.second) {
+        if (itSAT.second) vec_obs.push_back(itSAT.second.get());
+      }
+      store.add(itSITE.first, itEPO.first, vec_obs);
+    }
+    if (release) itSITE.second.clear();
+  }
+  store.shrink();
+
+  _gmutex.unlock();
+}
+
+// estimate of the heap of the observation maps
+// ----------
+size_t t_gallobs::memory()
+{
+  gtrace("t_gallobs::memory");
+
+  // std::map node: three pointers and the color, shared_ptr control block
+  const size_t node = 4 * sizeof(void*);
+  const size_t ctrl = 2 * sizeof(void*) + 2 * sizeof(int);
+
+  _gmutex.lock();
+
+  size_t bytes = 0;
+  for (auto& itSITE : _mapobj) {
+    bytes += node + sizeof(itSITE);
+    for (auto& itEPO : itSITE.second) {
+      bytes += node + sizeof(itEPO);
+      for (auto& itSAT : itEPO.second) {
+        bytes += node + sizeof(itSAT);
+        if (!itSAT.second) continue;
+        bytes += ctrl + sizeof(t_gobsgnss);
+        bytes += itSAT.second->obs().size() * (node + sizeof(pair<const GOBS, double>));
+        bytes += itSAT.second->lli().size() * (node + sizeof(pair<const GOBS, int>));
+        bytes += itSAT.second->slip().size() * (node + sizeof(pair<const GOBS, int>));
+      }
+    }
+  }
+
+  _gmutex.unlock();
+  return bytes;
+}
+
 
 // add observations ( both P and L in meters !!!)
 // ----------
 int t_gallobs::addobs(t_spt_gobs obs)
 {
   gtrace("t_gallobs::addobs");
-   
+
+  _sync_obs(obs);
+
+  t_gtime t(obs->epoch()),   tt = t;
+  string site = obs->site();
+//  cout << "ADDING site: " << site << endl;
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+
+  if (_map_sites.find(site) == _map_sites.end()) _map_sites.insert(site);
+
+  int  epo_found = _find_epo(site, t, tt);
+  int  irc = _addobs(obs, site, tt, epo_found, _mapobj[site][tt]);
+
+  _gmutex.unlock(); return irc;
+}
+
+
+// add observations of one site, e.g. a decoded epoch, with one lock
+// ----------
+int t_gallobs::addobs(const vector<t_spt_gobs>& obs)
+{
+  gtrace("t_gallobs::addobs");
+
+  for (const auto& one_obs : obs) {
+    if (one_obs) _sync_obs(one_obs);
+  }
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+
+  // the epoch of the previous obs is reused while site and time do not change
+  string      site;
+  t_gtime     t, tt;
+  int         epo_found = -1;
+  t_map_osat* sat_map = nullptr;
+  int         irc = 0;
+
+  for (const auto& one_obs : obs) {
+    if (!one_obs) continue;
+
+    if (!sat_map || _nepoch > 0 || one_obs->site() != site || one_obs->epoch() != t) {
+      site = one_obs->site();
+      t = one_obs->epoch();
+      tt = t;
+      if (_map_sites.find(site) == _map_sites.end()) _map_sites.insert(site);
+
+      epo_found = _find_epo(site, t, tt);
+
+      // decoded epochs are mostly appended
+      t_map_oref& site_map = _mapobj[site];
+      auto itEPO = site_map.find(tt);
+      if (itEPO == site_map.end()) itEPO = site_map.emplace_hint(site_map.end(), tt, t_map_osat());
+      sat_map = &itEPO->second;
+    }
+    else {
+      epo_found = 1;
+    }
+
+    irc = max(irc, _addobs(one_obs, site, tt, epo_found, *sat_map));
+  }
+
+  _gmutex.unlock(); return irc;
+}
+
+
+// move epochs out of sync (< 5 ms) to the full second
+// ----------
+void t_gallobs::_sync_obs(const t_spt_gobs& obs)
+{
   double outsync = fmod(obs->epoch().dsec(), _smp) - round(fmod(obs->epoch().dsec(), _smp));
   if (fabs(outsync) < 0.0051 && fabs(outsync) > 1e-6){
 	  obs->epo(obs->epoch() - outsync);
@@ -451,26 +667,21 @@ int t_gallobs::addobs(t_spt_gobs obs)
               obs->resetobs(*itOBS, obs->getobs(*itOBS));
 	  }
   }
+}
 
-  t_gtime t(obs->epoch()),   tt = t;
-  string site = obs->site();
-  string sat  = obs->sat();
-//  cout << "ADDING site: " << site << endl;
-
-  if (_map_sites.find(site) == _map_sites.end()) _map_sites.insert(site);
 
-#ifdef BMUTEX   
-  boost::mutex::scoped_lock lock(_mutex);
-#endif
-  _gmutex.lock();
-
-  int  epo_found = _find_epo(site, t, tt);
-  auto itSAT     = _mapobj[site][tt].find(sat);
+// add one observation to the epoch tt of site, _gmutex is locked by the caller
+// ----------
+int t_gallobs::_addobs(const t_spt_gobs& obs, const string& site, const t_gtime& tt, int epo_found, t_map_osat& sat_map)
+{
+  string sat  = obs->sat();
+  auto itSAT  = sat_map.find(sat);
+  bool trimmed = false;
 
   // add new observations (or overwrite)
   // ===================================
   if( _overwrite || epo_found < 0                     // epoch exists (smart search)
-                 || itSAT == _mapobj[site][tt].end()  // satellite exists
+                 || itSAT == sat_map.end()            // satellite exists
   ){
 #ifdef DEBUG
     cout << " ADDING " << site << " " <<  _mapobj[site].size() << " " << _nepoch // << " " <<  nepochs(site) // MUTEX !!!
@@ -480,9 +691,9 @@ int t_gallobs::addobs(t_spt_gobs obs)
     // delete old if exists
     // ====================
     if( _overwrite && epo_found > 0                     // epoch exists (smart search)
-                   && itSAT != _mapobj[site][tt].end()  // satellite exists    
+                   && itSAT != sat_map.end()            // satellite exists    
     ){
-        _mapobj[site][tt].erase(sat);
+        sat_map.erase(sat);
         if( _log && _log->verb() >= 2 ) _log->comment(2, "gallobs", site + tt.str_ymdhms(" obs replaced ") + sat);
     }
 
@@ -490,6 +701,7 @@ int t_gallobs::addobs(t_spt_gobs obs)
     // ============================
     if( _nepoch > 0 && _mapobj[site].size() > _nepoch + 10 ){  // +10 .. reduce number of removals to every tenths
 
+      trimmed = true;
       auto itEPO = _mapobj[site].begin();
       while( itEPO != _mapobj[site].end() ){
 
@@ -515,15 +727,17 @@ int t_gallobs::addobs(t_spt_gobs obs)
     // =================================
     if( obs->id_type() == t_gdata::OBSGNSS ){
 
-      _mapobj[site][tt][sat] = obs;
+      // sat_map may be removed with the old epochs
+      if( trimmed ) _mapobj[site][tt][sat] = obs;
+      else          sat_map[sat] = obs;
 
     }else{
        if( _log ){  _log->comment(0,"gallobs","warning: t_gobsgnss record not identified!"); }
-       _gmutex.unlock(); return 1;
+       return 1;
     }
   }else{
     if( _log && _log->verb() >= 2 ) _log->comment(2,"gallobs", site + tt.str_ymdhms(" skipped ") + " " + sat);
-    _gmutex.unlock(); return 0;
+    return 0;
   }
 
   // comments
@@ -537,7 +751,7 @@ int t_gallobs::addobs(t_spt_gobs obs)
 
     _log->comment(3,"gallobs",site + tt.str_ymdhms(" add obs: ") + " " + sat + lg.str() );
   }
-  _gmutex.unlock(); return 0;
+  return 0;
 }
 
 
@@ -35,6 +35,7 @@
 #include "gutils/gsys.h"
 #include "gutils/gobs.h"
 #include "gset/gsetgen.h"
+#include "gall/gobsstore.h"
 
 #define DIFF_SEC_NOMINAL 0.905  // [sec] returns observations within +- DIFF_SEC for 1Hz
 
@@ -47,6 +48,21 @@ namespace gnut
 {
 
 	typedef shared_ptr<t_gobsgnss> t_spt_gobs;
+
+	/**
+	*@brief observations of one epoch grouped by site, pointers into t_gallobs
+	*
+	* the obs of sites[i] are obs[beg[i]] ... obs[beg[i+1]-1], valid until the epoch is erased
+	*/
+	struct t_gobsview
+	{
+		vector<string>      sites;  ///< requested sites, also those without obs
+		vector<size_t>      beg;    ///< first obs of each site, size sites+1
+		vector<t_gobsgnss*> obs;    ///< obs of all sites, sorted by site and sat
+
+		/** @brief number of obs of site i */
+		size_t size(size_t i) const { return beg[i + 1] - beg[i]; }
+	};
 	/**
 	*@brief Class for t_allobs derive from t_gdata
 	*/
@@ -121,6 +137,14 @@ namespace gnut
 		virtual vector<t_gsatdata> obs(const string& site, const t_gtime& t);          // get all t_gsatdata for epoch t
 		virtual vector<t_gobsgnss*> obs(bool isPtr, const string& site, const t_gtime& t);
 		virtual vector<t_gsatdata> obs(const set<string>& sites, const t_gtime& t); // get all t_gsatdata for epoch t for all sites
+		/**
+		 * @brief get the obs of all sites for epoch t without copies
+		 *
+		 * @param sites
+		 * @param t
+		 * @param view  refilled, its capacity is kept
+		 */
+		void obs_view(const set<string>& sites, const t_gtime& t, t_gobsview& view);
 		/**
 		 * @brief get all t_gobsgnss pointers for epoch t
 		 *
@@ -183,6 +207,13 @@ namespace gnut
 		 * @return int
 		 */
 		int addobs(t_spt_gobs obs);                                       // add single station observation (P and L in meters !)
+		/**
+		 * @brief add observations, e.g. a decoded epoch of one station, with one lock
+		 *
+		 * @param obs  sorted by site and epoch, the same as addobs for each of them
+		 * @return int
+		 */
+		int addobs(const vector<t_spt_gobs>& obs);
 
 		void overwrite(bool b) { _overwrite = b; }                        // set/get overwrite mode
 		bool overwrite() { return _overwrite; }
@@ -220,23 +251,39 @@ namespace gnut
 		 * @param site
 		 * @param crd
 		 */
-		void addsitecrd(string site, t_gtriple crd) { _mapcrds[site] = crd; }
-		t_gtriple getsitecrd(string site) { return _mapcrds[site]; }
+		void addsitecrd(string site, t_gtriple crd);
+		t_gtriple getsitecrd(string site);
 		/**
 		 * @brief glo freq num
 		 *
 		 * @return map<string, int>
 		 */
-		map<string, int> glo_freq_num() { return _glofrq; }
+		map<string, int> glo_freq_num();
 		/**
 		 * @brief add glo freq
 		 *
 		 * @param sat
 		 * @param freqNum
 		 */
-		void add_glo_freq(string sat, int freqNum) { if (_glofrq.find(sat) == _glofrq.end()) _glofrq[sat] = freqNum; }
+		void add_glo_freq(string sat, int freqNum);
 		const set<string>& getSiteList() { return _map_sites; }
 
+		/**
+		 * @brief copy the observations of sites into the columnar store
+		 *
+		 * @param store    filled epoch by epoch, ascending
+		 * @param sites    stations, all if empty
+		 * @param release  release the maps of the stations once copied (moved into the store)
+		 */
+		void compact(t_gobsstore& store, const set<string>& sites, bool release = false);
+		/**
+		 * @brief estimate of the heap used by the observation maps [byte]
+		 *
+		 * @return size_t
+		 */
+		size_t memory();
+		double sampling() const { return _smp; }
+
 	protected:
 		virtual set<string>        _sats(const string& site, const t_gtime& t, GSYS gnss);
 		virtual set<GSYS>          _gsys(const string& site, const t_gtime& t);
@@ -244,6 +291,9 @@ namespace gnut
 		virtual vector<t_gobsgnss*> _gobs(bool isPtr, const string& site, const t_gtime& t);
 
 		int _find_epo(const string& site, const t_gtime& epo, t_gtime& tt);  // find epoch from the map w.r.t. DIFF_SEC
+		void _sync_obs(const t_spt_gobs& obs);                                // shift obs out of sync to the full epoch
+		int _addobs(const t_spt_gobs& obs, const string& site, const t_gtime& tt,
+			int epo_found, t_map_osat& sat_map);                             // add obs to epoch tt, _gmutex locked
 
 		t_gsetbase* _set;
 		unsigned int             _nepoch;      // maximum number of epochs (0 = keep all)
@@ -70,6 +70,8 @@ int t_gallprec::pos( string sat, const t_gtime& t, double xyz[], double var[], d
 {       
    gtrace("t_gallprec::pos");   
 
+  if( _frozen ) return _pos_frozen( sat, t, xyz, var, vel, chk_mask );
+
 #ifdef BMUTEX   
   boost::mutex::scoped_lock lock(_mutex);
 #endif
@@ -174,6 +176,29 @@ int t_gallprec::pos_int( string sat, const t_gtime& t, double xyz[], double var[
 int t_gallprec::pos_alt( string sat, const t_gtime& t, double xyz[], double var[], double vel[] )
 {      
    gtrace("t_gallprec::pos_alt");
+
+  if( _frozen ){
+    // stack-local window, no lock
+    vector<double> PT, X, Y, Z;
+    double ref = 0.0;
+    map<string, t_gprecarray>::const_iterator it = _frozen_crd.find(sat);
+    if( it == _frozen_crd.end() || _get_crddata( it->second, t, PT, X, Y, Z, ref ) < 0 ){
+      for(int i = 0; i<3; i++){
+                  xyz[i] = 0.0;
+        if( var ) var[i] = 0.0;
+        if( vel ) vel[i] = 0.0;
+      }
+      return -1;
+    }
+    double tdiff = t.diff(it->second.beg) - ref;
+    double tmp[3];
+    if( !var ) var = tmp;
+    t_gpoly poly;
+    poly.interpolate( PT, X, tdiff, xyz[0], var[0] );
+    poly.interpolate( PT, Y, tdiff, xyz[1], var[1] );
+    poly.interpolate( PT, Z, tdiff, xyz[2], var[2] );
+    return 1;
+  }
    
 #ifdef BMUTEX   
   boost::mutex::scoped_lock lock(_mutex);
@@ -204,6 +229,8 @@ int t_gallprec::pos_alt( string sat, const t_gtime& t, double xyz[], double var[
 // ----------
 int t_gallprec::clk( string sat, const t_gtime& t, double* clk, double* var, double* dclk, bool chk_mask )
 {   gtrace("t_gallprec::clk");   
+
+  if( _frozen ) return _clk_frozen( sat, t, clk, var, dclk, chk_mask );
    
 #ifdef BMUTEX   
   boost::mutex::scoped_lock lock(_mutex);
@@ -300,6 +327,23 @@ int t_gallprec::clk_int( string sat, const t_gtime& t, double* clk, double* var,
 int t_gallprec::clk_alt( string sat, const t_gtime& t, double* clk, double* var, double* dclk )
 {   
    gtrace("t_gallprec::clk_alt");   
+
+  if( _frozen ){
+    // stack-local window, no lock
+    vector<double> CT, C;
+    double ref = 0.0;
+    map<string, t_gprecarray>::const_iterator it = _frozen_clk.find(sat);
+    if( it == _frozen_clk.end() || _get_clkdata( it->second, t, CT, C, ref ) < 0 ){
+                *clk  = 0.0;
+      if( var ) *var  = 0.0;
+      if(dclk ) *dclk = 0.0;
+      return -1;
+    }
+    double tmp = 0.0;
+    t_gpoly poly;
+    poly.interpolate( CT, C, t.diff(it->second.beg) - ref, *clk, dclk ? *dclk : tmp );
+    return 1;
+  }
    
 #ifdef BMUTEX   
   boost::mutex::scoped_lock lock(_mutex);
@@ -465,6 +509,7 @@ int t_gallprec::add_delta_pos_vel(string sat, const t_gtime & ep, const int& iod
 	boost::mutex::scoped_lock lock(_mutex);
 #endif
 	_gmutex.lock();
+	_frozen = false;
 
 	if (_overwrite || _mapsp3[sat].find(ep) == _mapsp3[sat].end()) {
 
@@ -509,6 +554,7 @@ int t_gallprec::addpos( string sat, const t_gtime& ep, t_gtriple  xyz, double t,
   boost::mutex::scoped_lock lock(_mutex);
 #endif
   _gmutex.lock();
+  _frozen = false;
   
   if( _overwrite || _mapsp3[sat].find(ep) == _mapsp3[sat].end() ){
 
@@ -549,6 +595,7 @@ int t_gallprec::add_delta_clk(string sat, const t_gtime & ep, const int & iod, c
 	boost::mutex::scoped_lock lock(_mutex);
 #endif
 	_gmutex.lock();
+	_frozen = false;
 
 	if (_overwrite || _mapclk[sat].find(ep) == _mapclk[sat].end()) {
 
@@ -632,6 +679,7 @@ int t_gallprec::addvel(string sat, const t_gtime& ep, double xyzt[], double dxyz
 	boost::mutex::scoped_lock lock(_mutex);
 #endif
 	_gmutex.lock();
+	_frozen = false;
 
 	if (_overwrite || _mapsp3[sat].find(ep) == _mapsp3[sat].end()) {
 
@@ -671,6 +719,7 @@ int t_gallprec::add_pos_vel(string sat, const t_gtime& ep, t_gtriple xyz, double
 	boost::mutex::scoped_lock lock(_mutex);
 #endif
 	_gmutex.lock();
+	_frozen = false;
 	if (_overwrite || _mapsp3[sat].find(ep) == _mapsp3[sat].end()) {
 
 		_mapsp3[sat][ep]["X"] = xyz[0];
@@ -710,6 +759,7 @@ int t_gallprec::addclk( string sat, const t_gtime& ep, double clk[], double dxyz
   boost::mutex::scoped_lock lock(_mutex);
 #endif
   _gmutex.lock();
+  _frozen = false;
   
   if( _overwrite || _mapclk[sat].find(ep) == _mapclk[sat].end() ){
 
@@ -797,6 +847,7 @@ void t_gallprec::clean_outer( const t_gtime& beg, const t_gtime& end )
   boost::mutex::scoped_lock lock(_mutex);
 #endif
   _gmutex.lock();
+  _frozen = false;
 
   // prec ephemeris - loop over all satellites
   // -----------------------------------------
@@ -1706,4 +1757,263 @@ int t_gallprec::_get_delta_clk(const string & sat, const t_gtime & t, int iod, t
 	}
 }
 
+// value of data, 0.0 if not exists (as operator[] of t_map_dat)
+// ----------
+static double _frozen_value( const t_map_dat& data, const string& key )
+{
+  t_map_dat::const_iterator it = data.find(key);
+  return ( it == data.end() ) ? 0.0 : it->second;
+}
+
+
+// step of equally spaced epochs, 0.0 otherwise
+// ----------
+static double _frozen_step( const vector<double>& t )
+{
+  if( t.size() < 2 ) return 0.0;
+
+  double step = t[1] - t[0];
+  if( step <= 0.0 ) return 0.0;
+  for( size_t i = 2; i < t.size(); i++ ){
+    if( fabs(t[i] - t[i-1] - step) > 1e-6 ) return 0.0;
+  }
+  return step;
+}
+
+
+// first epoch equal|greater [than dt]
+// ----------
+int t_gallprec::t_gprecarray::index( double dt ) const
+{
+  int n = t.size();
+  if( step > 0.0 ){
+    double k = ceil( dt/step - 1e-9 );
+    if( k <= 0.0 ) return 0;
+    if( k >= n )   return n;
+    return static_cast<int>(k);
+  }
+  return lower_bound( t.begin(), t.end(), dt - 1e-9 ) - t.begin();
+}
+
+
+// build the read-only index
+// ----------
+void t_gallprec::freeze()
+{
+  gtrace("t_gallprec::freeze");
+
+#ifdef BMUTEX   
+  boost::mutex::scoped_lock lock(_mutex);
+#endif
+  _gmutex.lock();
+
+  _frozen_crd.clear();
+  _frozen_clk.clear();
+
+  for( t_map_prn::const_iterator itPRN = _mapsp3.begin(); itPRN != _mapsp3.end(); ++itPRN ){
+    if( itPRN->second.empty() ) continue;
+
+    t_gprecarray& data = _frozen_crd[itPRN->first];
+    data.beg = itPRN->second.begin()->first;
+    for( t_map_epo::const_iterator it = itPRN->second.begin(); it != itPRN->second.end(); ++it ){
+      data.t.push_back( it->first.diff(data.beg) );
+      data.x.push_back( _frozen_value(it->second, "X") );
+      data.y.push_back( _frozen_value(it->second, "Y") );
+      data.z.push_back( _frozen_value(it->second, "Z") );
+      data.c.push_back( _frozen_value(it->second, "C") );
+    }
+    data.step = _frozen_step( data.t );
+  }
+
+  for( t_map_prn::const_iterator itPRN = _mapclk.begin(); itPRN != _mapclk.end(); ++itPRN ){
+    if( itPRN->second.empty() ) continue;
+
+    t_gprecarray& data = _frozen_clk[itPRN->first];
+    data.beg = itPRN->second.begin()->first;
+    for( t_map_epo::const_iterator it = itPRN->second.begin(); it != itPRN->second.end(); ++it ){
+      data.t.push_back( it->first.diff(data.beg) );
+      data.c0.push_back( _frozen_value(it->second, "C0") );
+      data.c1.push_back( _frozen_value(it->second, "C1") );
+      data.c2.push_back( _frozen_value(it->second, "C2") );
+      data.ifcb.push_back( it->second.find("IFCB_F3") != it->second.end() );
+    }
+    data.step = _frozen_step( data.t );
+  }
+
+  _frozen = true;
+  if( _log ) _log->comment(2,"gallprec","frozen orbits: " + int2str(_frozen_crd.size())
+                                         + " clocks: " + int2str(_frozen_clk.size()));
+  _gmutex.unlock();
+}
+
+
+// pos from the read-only index (as t_gephprec::pos)
+// ----------
+int t_gallprec::_pos_frozen( const string& sat, const t_gtime& t, double xyz[], double var[], double vel[], bool chk_mask )
+{
+  for(int i = 0; i<3; i++){
+              xyz[i] = 0.0;
+    if( var ) var[i] = 0.0;
+    if( vel ) vel[i] = 0.0;
+  }
+
+  vector<double> PT, X, Y, Z;
+  double ref = 0.0;
+  map<string, t_gprecarray>::const_iterator it = _frozen_crd.find(sat);
+  if( it == _frozen_crd.end() || _get_crddata( it->second, t, PT, X, Y, Z, ref ) < 0 ){
+    if( _posnav && t_gallnav::pos( sat, t, xyz, var, vel, chk_mask ) >= 0 ){ return 1; }
+    return -1;
+  }
+
+  // reference epoch always in the mid of interval
+  double mid = ( PT.front() + PT.back() )/2;
+  for( size_t i = 0; i < PT.size(); i++ ) PT[i] -= mid;
+  double tdiff = t.diff(it->second.beg) - ref - mid;
+
+  t_gpoly poly_x, poly_y, poly_z;
+  poly_x.polynomials( PT, X );
+  if( fabs(tdiff) > fabs( poly_x.xref() - poly_x.span()/2 ) + 0.25 ) return -1;
+  poly_y.polynomials( PT, Y );
+  poly_z.polynomials( PT, Z );
+
+  poly_x.evaluate( tdiff, 0, xyz[0] );
+  poly_y.evaluate( tdiff, 0, xyz[1] );
+  poly_z.evaluate( tdiff, 0, xyz[2] );
+
+  if( vel ){
+    poly_x.evaluate( tdiff, 1, vel[0] );
+    poly_y.evaluate( tdiff, 1, vel[1] );
+    poly_z.evaluate( tdiff, 1, vel[2] );
+  }
+  return 1;
+}
+
+
+// clk from the read-only index
+// ----------
+int t_gallprec::_clk_frozen( const string& sat, const t_gtime& t, double* clk, double* var, double* dclk, bool chk_mask )
+{
+  vector<double> CT, C;
+  double ref = 0.0;
+  map<string, t_gprecarray>::const_iterator it = _frozen_clk.find(sat);
+  if( !_clkrnx || it == _frozen_clk.end() || _get_clkdata( it->second, t, CT, C, ref ) < 0 ){
+              *clk  = 0.0;
+    if( var ) *var  = 0.0;
+    if(dclk ) *dclk = 0.0;
+
+    if( _clksp3 &&  this->clk_int( sat, t, clk, var, dclk           ) >= 0 ){ return 1; }
+    if( _clknav && t_gallnav::clk( sat, t, clk, var, dclk, chk_mask ) >= 0 ){ return 1; }
+    return -1;
+  }
+
+  double tmp = 0.0;
+  if( !dclk ) dclk = &tmp;
+  t_gpoly poly;
+  poly.interpolate( CT, C, t.diff(it->second.beg) - ref, *clk, *dclk );
+  *dclk = *dclk / (CT.back() - CT.front());
+  return 1;
+}
+
+
+// fill PT,X,Y,Z vectors from the read-only index
+// ----------
+int t_gallprec::_get_crddata( const t_gprecarray& data, const t_gtime& t, vector<double>& PT,
+                              vector<double>& X, vector<double>& Y, vector<double>& Z, double& ref ) const
+{
+  int n = data.t.size();
+  int degree = static_cast<int>(_degree_sp3);
+  double dt = t.diff(data.beg);
+
+  int req = data.index(dt); // 1st equal|greater [than t]
+  if( req >= n ) return -1;
+  if( req > 0 && fabs(dt - data.t[req-1]) < fabs(dt - data.t[req]) ) req--;
+
+  ref = data.t[req];        // the nearest epoch as reference
+
+  // too few data
+  int limit = degree/2;
+  if( n < degree + 1 ) return -1;
+
+  int beg = req - limit;                                  // around requested item (standard case)
+  if( req < limit )                    beg = 0;           // start from the first item
+  else if( n - req < degree - limit )  beg = n - degree - 1; // start from the last item
+  beg = min( beg, n - degree - 1 );
+
+  for( int i = beg; i <= beg + degree; i++ ){
+    double tdiff = data.t[i] - ref;
+
+    // check maximum interval allowed between reference and sta/end epochs
+    if( fabs(tdiff) > static_cast<double>(degree*MAXDIFF_EPH) ) continue;
+
+    if( data.x[i] != UNDEFVAL_POS ){
+      PT.push_back( tdiff );
+       X.push_back( data.x[i] );
+       Y.push_back( data.y[i] );
+       Z.push_back( data.z[i] );
+    }
+  }
+
+  if( static_cast<int>(X.size()) != degree + 1 ) return -1;
+  return 1;
+}
+
+
+// fill CT,C vectors from the read-only index
+// ----------
+int t_gallprec::_get_clkdata( const t_gprecarray& data, const t_gtime& t, vector<double>& CT,
+                              vector<double>& C, double& ref ) const
+{
+  int n = data.t.size();
+  double dt = t.diff(data.beg);
+
+  int req = data.index(dt);          // 1st equal|greater [than t]
+  if( req >= n ) return -1;          // too old products
+  if( dt < 0.0 ) return -1;          // too new products
+
+  ref = data.t[req];                 // get the nearest epoch after t as reference
+
+  int beg = req - 1;
+  if( req == 0 )          beg = 0;
+  else if( req == n - 1 ) beg = n - 2;
+
+  // calculate
+  if( data.c1[beg] < UNDEFVAL_CLK ){
+    int i = beg;
+    double c = 0.0;
+    if( data.c2[beg] < UNDEFVAL_CLK && data.ifcb[beg] ){
+      if( ++i >= n ) return -1;
+      c = data.c0[i];
+    }else{
+      double tdiff = data.t[i] - dt;
+      c = data.c0[i] + data.c1[i]*tdiff;
+      if( data.c2[i] < UNDEFVAL_CLK ) c += data.c2[i]*tdiff*tdiff;
+    }
+    CT.push_back( data.t[i] - dt );
+     C.push_back( c );
+    return 1;
+  }
+
+  // interpolate
+  for( int i = beg; i <= beg + 1 && i < n; i++ ){
+    double tdiff = data.t[i] - ref;
+
+    // check maximum interval allowed between reference and sta/end epochs
+    if( fabs(tdiff) > MAXDIFF_CLK ) continue;
+
+    if( data.c0[i] != UNDEFVAL_CLK ){
+      CT.push_back( tdiff );
+       C.push_back( data.c0[i] );
+    }
+  }
+
+  if( C.size() != 2 ){
+    C.clear(); CT.clear();
+    if( req == 0 ) return -1;
+    C.push_back( data.c0[req-1] ); CT.push_back( data.t[req-1] - ref );
+    C.push_back( data.c0[req] );   CT.push_back( 0.0 );
+  }
+
+  return 1;
+}
+
 } // namespace
@@ -154,7 +154,7 @@ namespace gnut
 		/**
 		 * @brief clean all sp3
 		 */
-		void clean_all() { _mapsp3.clear(); _mapprec.clear(); }
+		void clean_all() { _mapsp3.clear(); _mapprec.clear(); _frozen = false; }
 		/**
 		 * @brief clean outer
 		 *
@@ -196,6 +196,17 @@ namespace gnut
 
 		set<clk_type> get_clk_type() const;
 
+		/**
+		 * @brief build the read-only index of the loaded SP3 and RINEX clock data
+		 * @note after freeze, pos/pos_alt/clk/clk_alt read the index without the mutex
+		 *       and keep the interpolation windows on the stack, so they can be called
+		 *       from any number of threads. Adding or cleaning data drops the index.
+		 */
+		void freeze();
+
+		/** @brief the read-only index is used */
+		bool frozen() const { return _frozen; }
+
 
 
 
@@ -210,6 +221,31 @@ namespace gnut
 		virtual int _get_delta_clk(const string& sat, const t_gtime& t);
 		virtual int _get_delta_clk(const string& sat, const t_gtime& t,int iod, t_gtime& tRef, t_map_dat& clkcorr);
 
+		/** @brief read-only orbit/clock data of one satellite, time sorted and contiguous */
+		struct t_gprecarray
+		{
+			t_gtime           beg;          ///< first epoch
+			double            step = 0.0;   ///< step [s] of equally spaced epochs, 0.0 otherwise
+			vector<double>    t;            ///< epochs [s] from beg
+			vector<double>    x, y, z, c;   ///< SP3 position [m] and clock [s]
+			vector<double>    c0, c1, c2;   ///< RINEX clock polynomial
+			vector<char>      ifcb;         ///< RINEX clock with IFCB_F3
+
+			/** @brief index of the 1st epoch equal|greater than dt [s from beg], O(1) if equally spaced */
+			int index(double dt) const;
+		};
+
+		int _pos_frozen(const string& sat, const t_gtime& t, double xyz[3], double var[3], double vel[3], bool chk_mask);
+		int _clk_frozen(const string& sat, const t_gtime& t, double* clk, double* var, double* dclk, bool chk_mask);
+
+		/** @brief as _get_crddata on the frozen data, ref [s from beg] */
+		int _get_crddata(const t_gprecarray& data, const t_gtime& t, vector<double>& PT,
+			vector<double>& X, vector<double>& Y, vector<double>& Z, double& ref) const;
+
+		/** @brief as _get_clkdata on the frozen data, ref [s from beg] */
+		int _get_clkdata(const t_gprecarray& data, const t_gtime& t, vector<double>& CT,
+			vector<double>& C, double& ref) const;
+
 		t_map_sat         _mapprec;     // map of sp3 polynomials
 		t_map_prn         _mapsp3;      // precise orbits&clocks (SP3) - full discrete data sets
 		t_map_prn         _mapclk;      // precise clocks (CLOCK-RINEX) - full discrete data sets
@@ -266,6 +302,11 @@ namespace gnut
 	  // END OF TEMPORARY (ALTERNATIVE)
 		// CLK TYPE
 		set<clk_type> _clk_type_list;
+
+		// READ-ONLY INDEX (freeze)
+		bool                         _frozen = false;
+		map<string, t_gprecarray>    _frozen_crd;   // SP3 positions and clocks
+		map<string, t_gprecarray>    _frozen_clk;   // RINEX clocks
 	};
 
 } // namespace
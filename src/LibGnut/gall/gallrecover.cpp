@@ -41,7 +41,21 @@ namespace great
 
 	void t_gallrecover::add_recover_equation(const t_grecover_equation& recover_equ)
 	{
-		t_grecover_equation* equ_data = new t_grecover_equation(recover_equ);
+		_add_recover_equation(new t_grecover_equation(recover_equ));
+	}
+
+	void t_gallrecover::add_recover_equation(const vector<t_grecover_equation*>& recover_equs)
+	{
+		_recover_data.reserve(_recover_data.size() + recover_equs.size());
+		for (auto equ_data : recover_equs)
+		{
+			_add_recover_equation(equ_data);
+		}
+	}
+
+	void t_gallrecover::_add_recover_equation(t_grecover_equation* equ_data)
+	{
+		const t_grecover_equation& recover_equ = *equ_data;
 
 		_add_common_data(equ_data);
 
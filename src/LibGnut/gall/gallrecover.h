@@ -48,6 +48,8 @@ namespace great
 		void add_allrecover(const t_gallrecover& other);
 		/** @brief add recover equation. */
 		void add_recover_equation(const t_grecover_equation& recover_equ);
+		/** @brief add recover equations in order, the ownership is taken. */
+		void add_recover_equation(const vector<t_grecover_equation*>& recover_equs);
 		/** @brief add recover parameter. */
 		void add_recover_par(const t_grecover_par& recover_par);
 		/** @brief get clk data. */
@@ -101,6 +103,7 @@ namespace great
 	private:
 
 		void _add_common_data(t_grecover_data*  data);
+		void _add_recover_equation(t_grecover_equation* equ_data);
 
 		// Mainly for index for time for and sat but no for storaging 
 		t_map_time_equ _time_equmap;
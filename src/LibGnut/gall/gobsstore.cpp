@@ -0,0 +1,258 @@
+/**
+ * @file         gobsstore.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        columnar store of observations, read by epoch views without copies
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gall/gobsstore.h"
+#include "gall/gallobs.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gnut
+{
+	double t_gobsrow::getobs(const GOBS& gobs) const
+	{
+		int slot = _slot(gobs);
+		if (slot < 0) return NULL_GOBS;
+
+		uint32_t idx = _site->row_val[_row] + slot;
+		return (_site->lli[idx] & 0x80) ? _site->val[idx] : NULL_GOBS;
+	}
+
+	int t_gobsrow::getlli(const GOBS& gobs) const
+	{
+		int slot = _slot(gobs);
+		if (slot < 0) return 0;
+
+		return _site->lli[_site->row_val[_row] + slot] & 0x7F;
+	}
+
+	vector<GOBS> t_gobsrow::obs() const
+	{
+		vector<GOBS> gobs;
+		const t_gobsslots& slots = _site->slots[_site->row_slots[_row]];
+		for (uint32_t idx = _site->row_val[_row]; idx < _site->row_val[_row + 1]; idx++)
+		{
+			if (_site->lli[idx] & 0x80) gobs.push_back(slots.gobs[idx - _site->row_val[_row]]);
+		}
+		// as the keys of t_gobsgnss
+		sort(gobs.begin(), gobs.end());
+		return gobs;
+	}
+
+	void t_gobsrow::get(t_gobsgnss& obs) const
+	{
+		obs.site(site());
+		obs.sat(sat());
+		obs.epo(epoch());
+		obs.channel(channel());
+
+		const t_gobsslots& slots = _site->slots[_site->row_slots[_row]];
+		for (uint32_t idx = _site->row_val[_row]; idx < _site->row_val[_row + 1]; idx++)
+		{
+			if (!(_site->lli[idx] & 0x80)) continue;
+			GOBS gobs = slots.gobs[idx - _site->row_val[_row]];
+			obs.addobs(gobs, _site->val[idx]);
+			obs.addlli(gobs, _site->lli[idx] & 0x7F);
+		}
+	}
+
+	int t_gobsrow::_slot(const GOBS& gobs) const
+	{
+		const t_gobsslots& slots = _site->slots[_site->row_slots[_row]];
+		if (gobs < 0 || gobs >= (int)slots.index.size()) return -1;
+
+		// rows added before a signal first occurred are shorter
+		int slot = slots.index[gobs];
+		if (slot < 0 || _site->row_val[_row] + slot >= _site->row_val[_row + 1]) return -1;
+		return slot;
+	}
+
+	t_gobsepoch::t_gobsepoch(const t_gobsstore_site* site, uint32_t epo) :
+		_site(site),
+		_epo(epo),
+		_beg(site->epo_row[epo]),
+		_end(site->epo_row[epo + 1])
+	{
+	}
+
+	t_gobsstore::t_gobsstore(double smp) :
+		_smp(smp)
+	{
+	}
+
+	t_gobsstore::~t_gobsstore()
+	{
+	}
+
+	void t_gobsstore::add(const string& site, const t_gtime& t, const vector<t_gobsgnss*>& obs)
+	{
+		t_gobsstore_site& rec = _sites[site];
+		if (rec.epo_row.empty())
+		{
+			rec.site = site;
+			rec.epo_row.push_back(0);
+			rec.row_val.push_back(0);
+		}
+		if (!rec.epochs.empty() && !(rec.epochs.back() < t)) return;
+
+		rec.epochs.push_back(t);
+		for (t_gobsgnss* one_obs : obs)
+		{
+			if (!one_obs) continue;
+
+			string sat = one_obs->sat();
+			auto sat_iter = rec.sat_index.find(sat);
+			if (sat_iter == rec.sat_index.end())
+			{
+				sat_iter = rec.sat_index.insert(make_pair(sat, (uint16_t)rec.sats.size())).first;
+				rec.sats.push_back(sat);
+			}
+
+			GSYS gsys = one_obs->gsys();
+			auto sys_iter = rec.sys_index.find(gsys);
+			if (sys_iter == rec.sys_index.end())
+			{
+				sys_iter = rec.sys_index.insert(make_pair(gsys, (uint8_t)rec.slots.size())).first;
+				rec.slots.push_back(t_gobsslots());
+				rec.slots.back().index.assign(X + 1, -1);
+			}
+			t_gobsslots& slots = rec.slots[sys_iter->second];
+
+			vector<GOBS> vec_gobs = one_obs->obs();
+			for (const GOBS& gobs : vec_gobs)
+			{
+				if (slots.index[gobs] < 0)
+				{
+					slots.index[gobs] = (int16_t)slots.gobs.size();
+					slots.gobs.push_back(gobs);
+				}
+			}
+
+			uint32_t off = rec.row_val.back();
+			rec.val.resize(off + slots.gobs.size(), NULL_GOBS);
+			rec.lli.resize(off + slots.gobs.size(), 0);
+			for (const GOBS& gobs : vec_gobs)
+			{
+				uint32_t idx = off + slots.index[gobs];
+				rec.val[idx] = one_obs->getobs(gobs);
+				rec.lli[idx] = 0x80 | (uint8_t)min(max(one_obs->getlli(gobs), 0), 0x7F);
+			}
+
+			rec.row_sat.push_back(sat_iter->second);
+			rec.row_slots.push_back(sys_iter->second);
+			rec.row_channel.push_back((int16_t)one_obs->channel());
+			rec.row_val.push_back((uint32_t)rec.val.size());
+		}
+		rec.epo_row.push_back((uint32_t)rec.row_sat.size());
+	}
+
+	t_gobsepoch t_gobsstore::epoch(const string& site, const t_gtime& t) const
+	{
+		auto iter = _sites.find(site);
+		if (iter == _sites.end()) return t_gobsepoch();
+
+		int epo = _find_epo(iter->second, t);
+		if (epo < 0) return t_gobsepoch();
+		return t_gobsepoch(&iter->second, epo);
+	}
+
+	set<string> t_gobsstore::sites() const
+	{
+		set<string> all_sites;
+		for (const auto& item : _sites) all_sites.insert(item.first);
+		return all_sites;
+	}
+
+	t_gtime t_gobsstore::end_obs(const string& site) const
+	{
+		auto iter = _sites.find(site);
+		if (iter == _sites.end() || iter->second.epochs.empty()) return FIRST_TIME;
+		return iter->second.epochs.back();
+	}
+
+	int t_gobsstore::end_obs_sites(const t_gtime& t, const set<string>& sites) const
+	{
+		int count = 0;
+		for (const auto& site : sites)
+		{
+			if (end_obs(site) < t) continue;
+			count++;
+		}
+		return count;
+	}
+
+	size_t t_gobsstore::rows() const
+	{
+		size_t num = 0;
+		for (const auto& item : _sites) num += item.second.row_sat.size();
+		return num;
+	}
+
+	size_t t_gobsstore::memory() const
+	{
+		// std::map node: three pointers and the color
+		const size_t node = 4 * sizeof(void*);
+
+		size_t bytes = sizeof(*this);
+		for (const auto& item : _sites)
+		{
+			const t_gobsstore_site& rec = item.second;
+			bytes += node + sizeof(item);
+			bytes += rec.epochs.capacity() * sizeof(t_gtime);
+			bytes += rec.epo_row.capacity() * sizeof(uint32_t);
+			bytes += rec.row_sat.capacity() * sizeof(uint16_t);
+			bytes += rec.row_slots.capacity() * sizeof(uint8_t);
+			bytes += rec.row_channel.capacity() * sizeof(int16_t);
+			bytes += rec.row_val.capacity() * sizeof(uint32_t);
+			bytes += rec.val.capacity() * sizeof(double);
+			bytes += rec.lli.capacity() * sizeof(uint8_t);
+			bytes += rec.sats.capacity() * sizeof(string);
+			for (const auto& slots : rec.slots)
+			{
+				bytes += sizeof(slots) + slots.gobs.capacity() * sizeof(GOBS) + slots.index.capacity() * sizeof(int16_t);
+			}
+			bytes += rec.sat_index.size() * (node + sizeof(pair<const string, uint16_t>));
+			bytes += rec.sys_index.size() * (node + sizeof(pair<const GSYS, uint8_t>));
+		}
+		return bytes;
+	}
+
+	void t_gobsstore::shrink()
+	{
+		for (auto& item : _sites)
+		{
+			t_gobsstore_site& rec = item.second;
+			rec.epochs.shrink_to_fit();
+			rec.epo_row.shrink_to_fit();
+			rec.row_sat.shrink_to_fit();
+			rec.row_slots.shrink_to_fit();
+			rec.row_channel.shrink_to_fit();
+			rec.row_val.shrink_to_fit();
+			rec.val.shrink_to_fit();
+			rec.lli.shrink_to_fit();
+		}
+	}
+
+	int t_gobsstore::_find_epo(const t_gobsstore_site& site, const t_gtime& t) const
+	{
+		if (site.epochs.empty()) return -1;
+
+		// closest of the neighbours, as t_gallobs::_find_epo
+		auto it1 = lower_bound(site.epochs.begin(), site.epochs.end(), t);
+		auto it0 = it1;
+		if (it0 != site.epochs.begin()) --it0;
+		if (it1 == site.epochs.end()) it1 = it0;
+
+		if (fabs(*it1 - t) <= DIFF_SEC(_smp)) return (int)(it1 - site.epochs.begin());
+		if (fabs(*it0 - t) <= DIFF_SEC(_smp)) return (int)(it0 - site.epochs.begin());
+		return -1;
+	}
+
+} // namespace
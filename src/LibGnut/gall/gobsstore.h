@@ -0,0 +1,189 @@
+/**
+ * @file         gobsstore.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        columnar store of observations, read by epoch views without copies
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GOBSSTORE_H
+#define GOBSSTORE_H
+
+#include "gexport/ExportLibGnut.h"
+#include "gdata/gobsgnss.h"
+#include "gutils/gtime.h"
+#include "gutils/gnss.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+namespace gnut
+{
+	/**
+	* @brief signal slots of one system of one station
+	* @note index maps GOBS to the slot, -1 if the signal never occurs
+	*/
+	struct t_gobsslots
+	{
+		vector<GOBS>    gobs;    ///< signal of each slot
+		vector<int16_t> index;   ///< slot of each GOBS
+	};
+
+	/**
+	* @brief observations of one station in columns
+	* @note rows are (epoch, satellite) ordered by epoch and satellite. The values of a row
+	*       are the slots of its system, lli holds the lost-of-lock indicator in the low 7 bits
+	*       and whether the signal is observed in the high bit.
+	*/
+	struct t_gobsstore_site
+	{
+		string           site;          ///< station id
+		vector<t_gtime>  epochs;        ///< epochs, ascending
+		vector<uint32_t> epo_row;       ///< first row of each epoch, size epochs+1
+		vector<uint16_t> row_sat;       ///< satellite of each row, index of sats
+		vector<uint8_t>  row_slots;     ///< slots of each row, index of slots
+		vector<int16_t>  row_channel;   ///< GLONASS channel of each row
+		vector<uint32_t> row_val;       ///< first value of each row, size rows+1
+		vector<double>   val;           ///< values of the slots of all rows
+		vector<uint8_t>  lli;           ///< lli and observed flag of the slots of all rows
+		vector<string>   sats;          ///< satellites of the station
+		vector<t_gobsslots> slots;      ///< signal slots of each system
+		map<string, uint16_t> sat_index;   ///< index of sats
+		map<GSYS, uint8_t>    sys_index;   ///< index of slots
+	};
+
+	/**
+	* @brief handle of one satellite of one epoch, valid while the store is not modified
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gobsrow
+	{
+	public:
+		t_gobsrow(const t_gobsstore_site* site, uint32_t epo, uint32_t row) : _site(site), _epo(epo), _row(row) {}
+
+		const string&  site() const { return _site->site; }
+		const string&  sat() const { return _site->sats[_site->row_sat[_row]]; }
+		const t_gtime& epoch() const { return _site->epochs[_epo]; }
+		int channel() const { return _site->row_channel[_row]; }
+
+		/** @brief observation of the signal, NULL_GOBS if not observed */
+		double getobs(const GOBS& gobs) const;
+
+		/** @brief lost-of-lock indicator of the signal, 0 if not observed */
+		int getlli(const GOBS& gobs) const;
+
+		/** @brief observed signals */
+		vector<GOBS> obs() const;
+
+		/** @brief set site, sat, epoch, channel of obs and add the observations (with lli) */
+		void get(t_gobsgnss& obs) const;
+
+	private:
+		int _slot(const GOBS& gobs) const;
+
+		const t_gobsstore_site* _site;   ///< station
+		uint32_t _epo;                   ///< epoch index
+		uint32_t _row;                   ///< row index
+	};
+
+	/**
+	* @brief all satellites of one station at one epoch
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gobsepoch
+	{
+	public:
+		/** @brief iterator over the rows */
+		class const_iterator
+		{
+		public:
+			const_iterator(const t_gobsepoch* epo, uint32_t row) : _epo(epo), _row(row) {}
+			t_gobsrow operator*() const { return t_gobsrow(_epo->_site, _epo->_epo, _row); }
+			const_iterator& operator++() { ++_row; return *this; }
+			bool operator!=(const const_iterator& other) const { return _row != other._row; }
+		private:
+			const t_gobsepoch* _epo;
+			uint32_t _row;
+		};
+
+		/** @brief empty epoch */
+		t_gobsepoch() : _site(nullptr), _epo(0), _beg(0), _end(0) {}
+		t_gobsepoch(const t_gobsstore_site* site, uint32_t epo);
+
+		bool   empty() const { return _beg == _end; }
+		size_t size() const { return _end - _beg; }
+		t_gobsrow operator[](size_t i) const { return t_gobsrow(_site, _epo, _beg + (uint32_t)i); }
+		const_iterator begin() const { return const_iterator(this, _beg); }
+		const_iterator end() const { return const_iterator(this, _end); }
+
+		/** @brief epoch of the observations, FIRST_TIME if empty */
+		t_gtime epoch() const { return _site ? _site->epochs[_epo] : FIRST_TIME; }
+
+	private:
+		const t_gobsstore_site* _site;   ///< station
+		uint32_t _epo;                   ///< epoch index
+		uint32_t _beg;                   ///< first row
+		uint32_t _end;                   ///< end row
+	};
+
+	/**
+	* @brief columnar store of the observations of all stations
+	* @note filled by t_gallobs::compact (or add) epoch by epoch in ascending order, read only afterwards.
+	*       Per station the epochs, satellites and signals are indexed once and the values of all
+	*       rows are kept in a few flat arrays instead of maps of t_gobsgnss.
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gobsstore
+	{
+	public:
+		/**
+		* @brief constructor
+		* @param[in] smp sampling [s], epochs are found within DIFF_SEC(smp) as t_gallobs does
+		*/
+		explicit t_gobsstore(double smp = 0.0);
+
+		/** @brief default destructor */
+		~t_gobsstore();
+
+		/**
+		* @brief append one epoch of a station
+		* @note the epoch must be later than the last epoch of the station
+		*/
+		void add(const string& site, const t_gtime& t, const vector<t_gobsgnss*>& obs);
+
+		/** @brief all satellites of site at the epoch closest to t, empty if none */
+		t_gobsepoch epoch(const string& site, const t_gtime& t) const;
+
+		/** @brief stations */
+		set<string> sites() const;
+
+		/** @brief last epoch of site, FIRST_TIME if none */
+		t_gtime end_obs(const string& site) const;
+
+		/** @brief number of stations whose last epoch is not before t */
+		int end_obs_sites(const t_gtime& t, const set<string>& sites) const;
+
+		/** @brief number of rows (epoch, satellite) of all stations */
+		size_t rows() const;
+
+		/** @brief heap and object size of the store [byte] */
+		size_t memory() const;
+
+		/** @brief release the spare capacity of the arrays */
+		void shrink();
+
+	private:
+		/** @brief epoch index of site within DIFF_SEC, -1 if none */
+		int _find_epo(const t_gobsstore_site& site, const t_gtime& t) const;
+
+		double _smp;                               ///< sampling [s]
+		map<string, t_gobsstore_site> _sites;      ///< stations
+	};
+
+} // namespace
+
+#endif // !GOBSSTORE_H
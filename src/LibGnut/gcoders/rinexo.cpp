@@ -15,21 +15,68 @@
 #include <cstring>
 #include <memory>
 #include <algorithm>
+#include <fstream>
 
 #include "gcoders/rinexo.h"
 #include "gdata/gobsgnss.h"
+#include "md5/md5.h"
  
 using namespace std;
 
 namespace gnut {
 
+// binary cache of the decoded observations
+//   - header lines (replayed), filter statistics and the filled epochs
+//   - native byte order, the cache is local to the machine
+// ----------
+static const char CACHE_MAGIC[8] = { 'G','O','B','S','C','A','C','H' };
+static const int  CACHE_VERSION  = 2;
+
+template<class T> static void cache_put( string& buff, const T& val )
+{
+  buff.append( (const char*)&val, sizeof(T) );
+}
+
+template<class T> static bool cache_get( const char*& ptr, const char* end, T& val )
+{
+  if( end - ptr < (ptrdiff_t)sizeof(T) ) return false;
+  memcpy( &val, ptr, sizeof(T) );
+  ptr += sizeof(T);
+  return true;
+}
+
+static void cache_put_time( string& buff, const t_gtime& t )
+{
+  cache_put( buff, (int)t.tsys() );
+  cache_put( buff, t.mjd(false) );
+  cache_put( buff, t.sod(false) );
+  cache_put( buff, t.dsec(false) );
+}
+
+static bool cache_get_time( const char*& ptr, const char* end, t_gtime& t )
+{
+  int tsys, mjd, sod;
+  double dsec;
+  if( !cache_get(ptr, end, tsys) || !cache_get(ptr, end, mjd) ||
+      !cache_get(ptr, end, sod)  || !cache_get(ptr, end, dsec) ) return false;
+  t = t_gtime( (t_gtime::t_tsys)tsys );
+  t.from_mjd( mjd, sod, dsec, false );
+  return true;
+}
+
 // constructor
 // ----------
 t_rinexo::t_rinexo( t_gsetbase* s, string version, int sz )
-  : t_rinexo3( s, version, sz )
+  : t_rinexo3( s, version, sz ),
+    _cache_rec(false),
+    _cache_nepo(0),
+    _fill_epo(0,0)
 {}
 t_rinexo::t_rinexo(t_gtime beg, t_gtime end, t_gsetbase* s, string version, int sz)
-	: t_rinexo3(beg, end, s, version, sz)
+	: t_rinexo3(beg, end, s, version, sz),
+	_cache_rec(false),
+	_cache_nepo(0),
+	_fill_epo(0,0)
 {
 
 }
@@ -614,6 +661,7 @@ int t_rinexo::_decode_head()
     // -------- "END OF HEADER" --------
     }else if( _line.find("END OF HEADER",60) != string::npos ){
       if( _log ) _log->comment(2,"rinexo","END OF HEADER ");
+      if( _cache_rec ) _cache_head(_tmpsize);
       t_gcoder::_consume(_tmpsize);
       _rnxhdr.mapobs(_mapobs);
       _rnxhdr.mapcyc(_mapcyc);
@@ -633,7 +681,10 @@ int t_rinexo::_decode_head()
     _rnxhdr.comment(_comment); 
 
     // -------- CONSUME --------
-    if( _complete ) _consume += t_gcoder::_consume(_tmpsize);    
+    if( _complete ){
+      if( _cache_rec ) _cache_head(_tmpsize);
+      _consume += t_gcoder::_consume(_tmpsize);
+    }
     else break;
   }
 
@@ -675,4 +726,213 @@ int t_rinexo::_decode_data()
   return _consume;
 }
 
+
+// fill observation data structure (and record the epoch for the cache)
+//   - recorded before filled, the container syncs the epoch and values in place
+// ----------
+int t_rinexo::_fill_data()
+{
+  gtrace("t_rinexo::_fill_data");
+
+  if( _cache_rec ){
+    cache_put_time( _cache_dat, _epoch );
+    cache_put( _cache_dat, (int)_vobs.size() );
+    for( auto itOBS = _vobs.begin(); itOBS != _vobs.end(); ++itOBS ){
+      string sat = (*itOBS)->sat();
+      cache_put( _cache_dat, (int)sat.size() );
+      _cache_dat.append( sat );
+
+      vector<GOBS> vec_gobs = (*itOBS)->obs();
+      cache_put( _cache_dat, (int)vec_gobs.size() );
+      for( auto itGOBS = vec_gobs.begin(); itGOBS != vec_gobs.end(); ++itGOBS ){
+        cache_put( _cache_dat, (int)*itGOBS );
+        cache_put( _cache_dat, (*itOBS)->getobs(*itGOBS) );
+        cache_put( _cache_dat, (*itOBS)->getlli(*itGOBS) );
+      }
+    }
+    _cache_nepo++;
+  }
+
+  int cnt = t_rinexo2::_fill_data();
+
+  // epoch synced by the container (moved to the full second)
+  _fill_epo = _vobs.empty() ? _epoch : _vobs.front()->epoch();
+
+  return cnt;
+}
+
+
+// record header lines at the buffer begin (before consumed)
+// ----------
+void t_rinexo::_cache_head(int size)
+{
+  const char* buff = 0;
+  int len = t_gcoder::_getbuffer( buff );
+  if( buff && len > 0 ) _cache_hdr.append( buff, min(size, len) );
+}
+
+
+// cache file name of the file content and decoding settings
+// ----------
+string t_rinexo::cache_name(const string& md5sum)
+{
+  gtrace("t_rinexo::cache_name");
+
+  ostringstream os;
+  os << CACHE_VERSION << " " << md5sum
+     << " " << _beg.str_ymdhms() << " " << _end.str_ymdhms()
+     << " " << beg_epoch.str_ymdhms() << " " << end_epoch.str_ymdhms()
+     << " " << setprecision(12) << _int << " " << _scl;
+
+  for( auto it = _sys.begin(); it != _sys.end(); ++it ) os << " SYS:" << *it;
+  for( auto it = _rec.begin(); it != _rec.end(); ++it ) os << " REC:" << *it;
+  for( auto it = _sat.begin(); it != _sat.end(); ++it ){
+    os << " SAT" << int(it->first) << ":";
+    for( auto itSAT = it->second.begin(); itSAT != it->second.end(); ++itSAT ) os << " " << *itSAT;
+  }
+  for( auto it = _obs.begin(); it != _obs.end(); ++it ){
+    os << " OBS" << int(it->first) << ":";
+    for( auto itOBS = it->second.begin(); itOBS != it->second.end(); ++itOBS ) os << " " << *itOBS;
+  }
+
+  return md5( os.str() ) + ".gobs";
+}
+
+
+// write recorded header and epochs to the cache file
+//   - written to a temporary file and renamed, never read incomplete
+// ----------
+int t_rinexo::cache_write(const string& path)
+{
+  gtrace("t_rinexo::cache_write");
+
+  if( _cache_hdr.empty() ) return -1;
+
+  string head;
+  head.append( CACHE_MAGIC, sizeof(CACHE_MAGIC) );
+  cache_put( head, CACHE_VERSION );
+  cache_put( head, (int)_cache_hdr.size() );
+  head.append( _cache_hdr );
+  cache_put( head, _xbeg );
+  cache_put( head, _xend );
+  cache_put( head, _xsmp );
+  cache_put( head, _xsys );
+  cache_put_time( head, _epo_beg );
+  cache_put_time( head, _epo_end );
+  cache_put( head, _cache_nepo );
+
+  string tmp = path + ".tmp";
+  ofstream os( tmp.c_str(), ios::binary | ios::trunc );
+  if( !os ){
+    if( _log ) _log->comment(1,"rinexo","Warning: cache not written " + path);
+    return -1;
+  }
+  os.write( head.data(), head.size() );
+  os.write( _cache_dat.data(), _cache_dat.size() );
+  os.close();
+  if( os.fail() ){ remove( tmp.c_str() ); return -1; }
+
+  remove( path.c_str() );
+  if( rename( tmp.c_str(), path.c_str() ) != 0 ){ remove( tmp.c_str() ); return -1; }
+
+  if( _log ) _log->comment(2,"rinexo","cache written " + path + " epochs: " + int2str(_cache_nepo));
+  return _cache_nepo;
+}
+
+
+// decode header and epochs from the cache file
+//   - the whole file validated before anything is filled
+// ----------
+int t_rinexo::cache_read(const string& path)
+{
+  gtrace("t_rinexo::cache_read");
+
+  ifstream is( path.c_str(), ios::binary | ios::ate );
+  if( !is ) return -1;
+
+  streamoff size = is.tellg();
+  if( size < (streamoff)sizeof(CACHE_MAGIC) ) return -1;
+  vector<char> buff( (size_t)size );
+  is.seekg( 0 );
+  if( !is.read( buff.data(), size ) ) return -1;
+
+  const char* ptr = buff.data();
+  const char* end = ptr + size;
+  if( memcmp( ptr, CACHE_MAGIC, sizeof(CACHE_MAGIC) ) != 0 ) return -1;
+  ptr += sizeof(CACHE_MAGIC);
+
+  int version, nhdr, xbeg, xend, xsmp, xsys, nepo;
+  t_gtime epo_beg, epo_end;
+  if( !cache_get(ptr, end, version) || version != CACHE_VERSION ) return -1;
+  if( !cache_get(ptr, end, nhdr) || nhdr <= 0 || end - ptr < nhdr ) return -1;
+  const char* hdr = ptr;
+  ptr += nhdr;
+  if( !cache_get(ptr, end, xbeg) || !cache_get(ptr, end, xend) ||
+      !cache_get(ptr, end, xsmp) || !cache_get(ptr, end, xsys) ||
+      !cache_get_time(ptr, end, epo_beg) || !cache_get_time(ptr, end, epo_end) ||
+      !cache_get(ptr, end, nepo) || nepo < 0 ) return -1;
+
+  // validate the epochs
+  const ptrdiff_t obs_size = 2*sizeof(int) + sizeof(double);
+  const char* dat = ptr;
+  for( int i = 0; i < nepo; i++ ){
+    t_gtime epo;
+    int nsat, len, nobs;
+    if( !cache_get_time(ptr, end, epo) || !cache_get(ptr, end, nsat) || nsat < 0 ) return -1;
+    for( int j = 0; j < nsat; j++ ){
+      if( !cache_get(ptr, end, len) || len < 0 || end - ptr < len ) return -1;
+      ptr += len;
+      if( !cache_get(ptr, end, nobs) || nobs < 0 || (end - ptr) / obs_size < nobs ) return -1;
+      ptr += nobs * obs_size;
+    }
+  }
+  if( ptr != end ) return -1;
+
+  // header replayed through the decoder (site, receiver objects)
+  vector<string> errmsg;
+  vector<char> head( hdr, hdr + nhdr );
+  if( decode_head( head.data(), nhdr, errmsg ) >= 0 ) return -1;
+
+  // epochs filled as decoded
+  _mutex.lock();
+  ptr = dat;
+  for( int i = 0; i < nepo; i++ ){
+    int nsat, len, nobs, gobs, lli;
+    double val;
+    cache_get_time( ptr, end, _epoch );
+    cache_get( ptr, end, nsat );
+
+    _vobs.clear();
+    for( int j = 0; j < nsat; j++ ){
+      cache_get( ptr, end, len );
+      string sat( ptr, len );
+      ptr += len;
+
+      t_spt_gobs obs = make_shared<t_gobsgnss>( _site, sat, _epoch );
+      cache_get( ptr, end, nobs );
+      for( int k = 0; k < nobs; k++ ){
+        cache_get( ptr, end, gobs );
+        cache_get( ptr, end, val );
+        cache_get( ptr, end, lli );
+        obs->addobs( (GOBS)gobs, val );
+        obs->addlli( (GOBS)gobs, lli );
+      }
+      _vobs.push_back( obs );
+    }
+    _count += t_rinexo2::_fill_data();
+  }
+  _vobs.clear();
+
+  _xbeg    = xbeg;
+  _xend    = xend;
+  _xsmp    = xsmp;
+  _xsys    = xsys;
+  _epo_beg = epo_beg;
+  _epo_end = epo_end;
+  _mutex.unlock();
+
+  if( _log ) _log->comment(2,"rinexo","cache read " + path + " epochs: " + int2str(nepo));
+  return nepo;
+}
+
 } // namespace
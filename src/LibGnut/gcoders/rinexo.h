@@ -63,9 +63,25 @@ class LibGnut_LIBRARY_EXPORT t_rinexo : public t_rinexo3 {
 
   void setSite(string site) { _encode_site = site; };
 
+  string cache_name(const string& md5sum);          // cache file name of the file content (md5sum) and decoding settings
+  void   cache_record(bool b){ _cache_rec = b; }    // record decoded header and epochs for the cache
+  int    cache_write(const string& path);           // write recorded header and epochs to the cache file
+  int    cache_read(const string& path);            // decode header and epochs from the cache file instead of RINEX
+
+  t_gtime fill_epoch()const{ return _fill_epo; }   // last epoch filled in the data container (synced)
+
  protected:
   virtual  int _decode_head();
   virtual  int _decode_data();
+  virtual  int _fill_data();                        // fill observation data structure (and record the epoch)
+
+  void    _cache_head(int size);                    // record header lines at the buffer begin
+
+  bool    _cache_rec;                               // record for the cache
+  string  _cache_hdr;                               // recorded header lines
+  string  _cache_dat;                               // recorded epochs (binary)
+  int     _cache_nepo;                              // # of recorded epochs
+  t_gtime _fill_epo;                                // last filled epoch
 
  private:
 
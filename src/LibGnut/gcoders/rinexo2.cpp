@@ -169,10 +169,13 @@ int t_rinexo2::_decode_head()
     if( ! _fname.empty() ){
         if (_fname.length() > 8 + 4 && n >= 5) {
             auto pos = filename.find(".rnx");
+            if (pos == filename.npos) pos = filename.find(".crx");
             if (pos != filename.npos) { guess = filename.substr(pos - 34, 9); src = "FILE"; typ = "long"; sit = "(9-CH)"; }
         } // LONG  FILE NAME
         else {
-            guess = filename.substr(filename.find_last_of("o") - 11, 4); src = "FILE"; typ = "short"; sit = "(4-CH)";
+            // ssssdddf.yyo or compact ssssdddf.yyd
+            auto pos = filename.find_last_of("oOdD");
+            if (pos != filename.npos && pos >= 11) { guess = filename.substr(pos - 11, 4); src = "FILE"; typ = "short"; sit = "(4-CH)"; }
         }// SHORT FILE NAME
       transform(guess.begin(), guess.end(), guess.begin(), ::toupper);
 
@@ -830,6 +833,7 @@ int t_rinexo2::_read_obs(const unsigned int& idx,
         else if( i == 7 ) obs->addobs( snrtype, 45.0);
         else if( i == 8 ) obs->addobs( snrtype, 50.0);
         else if( i == 9 ) obs->addobs( snrtype, 60.0);
+        else              obs->addobs( snrtype,  0.0);
 		 
       }else{ obs->addobs( snrtype,  0.0); }
     }
@@ -940,17 +944,16 @@ int t_rinexo2::_fill_data()
     }
 
     vector<t_spt_gobs>::const_iterator itOBS = _vobs.begin();	    
-    while( itOBS != _vobs.end() ){
+    while( _log && _log->verb() >= 4 && itOBS != _vobs.end() ){
        
-      if( _log && _log->verb() >= 4 )
-          _log->comment(1,"rinexo2",(*itOBS)->sat() + " obs filled "
-                                  + (*itOBS)->epoch().str_ymdhms()
-                            + " " + (*itOBS)->site());
-
-      ((t_gallobs*)itDAT->second)->addobs( *itOBS );
-              
+      _log->comment(1,"rinexo2",(*itOBS)->sat() + " obs filled "
+                              + (*itOBS)->epoch().str_ymdhms()
+                        + " " + (*itOBS)->site());
       itOBS++;
     }
+
+    // the whole epoch with one lock
+    ((t_gallobs*)itDAT->second)->addobs( _vobs );
     cnt++;
     itDAT++;  
   }
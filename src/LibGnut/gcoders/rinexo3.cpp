@@ -18,20 +18,62 @@
 
 #include "gcoders/rinexo3.h"
 #include "gdata/gobsgnss.h"
+#include "gset/gsetproc.h"
  
 using namespace std;
 
 namespace gnut {
 
+// SNR flag (1-9) to dBHz
+static const double SNR_FLAG_DBHZ[9] = { 6.0, 15.0, 20.0, 27.0, 33.0, 39.0, 45.0, 50.0, 60.0 };
+
+// exact powers of ten for the fixed-format fields
+static const double POW10[15] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14 };
+
+// fixed-column field (F14.3) to double
+//   - plain decimal numbers only, identical to strtod (integer mantissa / exact power of ten)
+//   - false for anything else (exponent, hex, garbage), to be converted by str2dbl
+// ----------
+static bool fast_str2dbl( const char* p, const char* end, double& val )
+{
+  while( p < end && *p == ' ' ) p++;
+  if( p == end ){ val = 0.0; return true; }   // blank => 0.0
+
+  bool neg = false;
+  if( *p == '-' || *p == '+' ){ neg = ( *p == '-' ); p++; }
+
+  long long mant = 0;
+  int ndig = 0;
+  int nfrac = 0;
+  while( p < end && *p >= '0' && *p <= '9' ){ mant = mant*10 + (*p - '0'); ndig++; p++; }
+  if( p < end && *p == '.' ){
+    p++;
+    while( p < end && *p >= '0' && *p <= '9' ){ mant = mant*10 + (*p - '0'); ndig++; nfrac++; p++; }
+  }
+
+  if( ndig == 0 || ndig > 15 ) return false;
+  if( p < end && *p != ' ' && *p != '\n' && *p != '\r' ) return false;
+
+  val = (double)mant / POW10[nfrac];
+  if( neg ) val = -val;
+  return true;
+}
+
 // constructor
 // ----------
 t_rinexo3::t_rinexo3( t_gsetbase* s, string version, int sz )
-  : t_rinexo2( s, version, sz )
+  : t_rinexo2( s, version, sz ),
+    _fast(false)
 {
+  t_gsetproc* set_proc = dynamic_cast<t_gsetproc*>(_set);
+  if( set_proc ) _fast = set_proc->rinexo_fast();
 }
 t_rinexo3::t_rinexo3(t_gtime beg, t_gtime end, t_gsetbase* s, string version, int sz)
-	: t_rinexo2(beg, end, s, version, sz)
+	: t_rinexo2(beg, end, s, version, sz),
+	_fast(false)
 {
+	t_gsetproc* set_proc = dynamic_cast<t_gsetproc*>(_set);
+	if (set_proc) _fast = set_proc->rinexo_fast();
 }
    
 // OBS-RINEX header
@@ -42,6 +84,10 @@ int t_rinexo3::_decode_head()
 { 
   gtrace("t_rinexo3::decode_head");
 
+  // header (observation types) may change
+  _fastsat.clear();
+  _fastfields.clear();
+
   // -------- "SYS / # / OBS TYPES" --------
   if( _line.substr(60,19).find("SYS / # / OBS TYPES") != string::npos ){
 
@@ -397,9 +443,17 @@ int t_rinexo3::_decode_data()
 
   // DATA READING 
   // ------------
+  // records scanned in the buffer, the original reading kept for the detailed log
+  bool fast = _fast && !( _log && _log->verb() >= 4 );
+
   // loop over satellits records (x-lines)
   for( int i = 0; i < _nsat; i++ ){
 
+    if( fast ){
+      if( t_rinexo3::_read_obstypes_fast() < 0 ){ _complete = 0; return -1; }
+      continue;
+    }
+
     string sat = "";
     string key = "";
   
@@ -577,6 +631,107 @@ int t_rinexo3::_read_obstypes( const string& sat, const string& sys )
 
   return 1;
 }
+
+
+// read satellite observation types directly from the buffer
+//   - same as _read_obstypes + _read_obs, but without the line copy
+//   - satellite and fields of its system are resolved once
+// ----------
+int t_rinexo3::_read_obstypes_fast()
+{
+  gtrace("t_rinexo3::_read_obstypes_fast");
+
+  const char* buff = 0;
+  int size = t_gcoder::_getbuffer( buff );
+  if( _tmpsize >= size ) return _stop_read();
+
+  // read new line for individual satellite (complete observations)
+  const char* line = buff + _tmpsize;
+  const char* eol  = (const char*)memchr( line, '\n', size - _tmpsize );
+  if( !eol ) return _stop_read();
+
+  unsigned int len = eol - line + 1;
+  if( len < 3 ) return _stop_read();
+  _tmpsize += len;
+
+  int key = ((unsigned char)line[0] << 16) | ((unsigned char)line[1] << 8) | (unsigned char)line[2];
+  map<int, t_fastsat>::const_iterator itSAT = _fastsat.find(key);
+  if( itSAT == _fastsat.end() ){
+    t_fastsat fastsat;
+    fastsat.sat    = t_gsys::eval_sat( string(line+1, 2), t_gsys::char2gsys(line[0]) );
+    fastsat.filter = _filter_gnss(fastsat.sat);
+
+    string gs = fastsat.sat.substr(0,1);
+    map<string, vector<t_fastfield> >::iterator itFLD = _fastfields.find(gs);
+    if( itFLD == _fastfields.end() ){
+      GSYS gsys = t_gsys::char2gsys(fastsat.sat[0]);
+      vector<t_fastfield> fields;
+      for( const auto& item : _mapobs[gs] ){
+        t_fastfield field;
+        field.type    = item.first;
+        field.factor  = item.second;
+        field.use     = !( _obs[gsys].size() > 0 && _obs[gsys].find( gobs2str(item.first) ) == _obs[gsys].end() );
+        field.lli     = !( item.first >=  300 && item.first <  400 ) &&   // signal-to-noise ratio
+                        !( item.first >= 1300 && item.first < 1400 );
+        field.phase   = field.lli && item.first >= 100 && item.first < 200;
+        field.snrtype = field.phase ? pha2snr(item.first) : item.first;
+        fields.push_back(field);
+      }
+      itFLD = _fastfields.insert( make_pair(gs, fields) ).first;
+    }
+    fastsat.fields = &itFLD->second;
+    itSAT = _fastsat.insert( make_pair(key, fastsat) ).first;
+  }
+  const t_fastsat& fastsat = itSAT->second;
+
+  // filter GNSS and SAT
+  if( ! fastsat.filter ){ _xsys++; if( _log ) _log->comment( 2, "rinexo2", "skip "+fastsat.sat); return 1; }
+
+  t_spt_gobs obs = make_shared<t_gobsgnss>(_site, fastsat.sat, _epoch);
+
+  // loop over sys-defined observation types
+  const vector<t_fastfield>& fields = *fastsat.fields;
+  for( unsigned int ii = 0; ii < fields.size(); ii++ ){
+
+    const t_fastfield& field = fields[ii];
+    unsigned int idx = 3 + 16*ii;
+
+    // check completness (excluding last SNR+LLI - sometimes missing)
+    if( len < (idx + 14) || !field.use ) continue;
+
+    double valdbl = 0.0;
+    if( !fast_str2dbl( line + idx, line + idx + 14, valdbl ) ) valdbl = str2dbl( string(line + idx, 14) );
+    if( double_eq(valdbl, 0.0) ) continue;                                   // eliminate 0.000
+
+    obs->addobs( field.type, valdbl * field.factor );
+
+    // only for C,L,D, but not SNR observations !!
+    if( !field.lli ) continue;
+
+    int lli = 0;
+    if( len - 1 > (idx + 14) ){
+      char c = line[idx + 14];
+      if( c >= '0' && c <= '9' ) lli = c - '0';
+      // RINEX305: Bit 2 set: BOC-tracking of an MBOC-modulated signal (may suffer from increased noise).
+      if( lli > 3 ) lli -= 4;
+    }
+    obs->addlli( field.type, lli );
+
+    // only for phase observations !
+    if( !field.phase ) continue;
+
+    if( len - 1 > (idx + 14 + 1) ){
+      char c = line[idx + 14 + 1];
+      if(      c == ' ' || c == '\t' ) obs->addobs( field.snrtype, 0.0 );
+      else if( c >= '1' && c <= '9' ) obs->addobs( field.snrtype, SNR_FLAG_DBHZ[c - '1'] );
+      else                            obs->addobs( field.snrtype, 0.0 );
+    }else{ obs->addobs( field.snrtype, 0.0 ); }
+  }
+
+  _vobs.push_back(obs);
+
+  return 1;
+}
  
 
 // fix band
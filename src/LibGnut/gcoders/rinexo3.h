@@ -25,6 +25,7 @@
 #ifndef RINEXO3_H
 #define RINEXO3_H
 
+#include <map> 
 #include <string> 
 #include <vector> 
 
@@ -66,11 +67,37 @@ class LibGnut_LIBRARY_EXPORT t_rinexo3 : public t_rinexo2 {
   virtual int _check_head();                                           // fill header information
   virtual int _read_epoch();                                           // read epoch & number of satellites, return flag
   virtual int _read_obstypes(const string& sat, const string& sys);    // read single satellite observation types
+  virtual int _read_obstypes_fast();                                   // read single satellite observation types from the buffer
   virtual int _fix_band(string sys, string& go);                       // fix band (BDS)
 
   t_rnxhdr::t_obstypes       _mapcyc;     // map of GOBS phase quater-cycle shifts
   t_rnxhdr::t_obstypes       _glofrq;     // map of GLONASS slot/frequency
   t_rnxhdr::t_vobstypes      _globia;     // vec of GLONASS obs code-phase biases
+
+  /**
+  *@brief observation field of a system record, resolved once from the header
+  */
+  struct t_fastfield {
+    GOBS   type;                          // observation type
+    double factor;                        // scale factor
+    bool   use;                           // observation type requested
+    bool   lli;                           // LLI (not for SNR)
+    bool   phase;                         // SNR flag to be converted
+    GOBS   snrtype;                       // SNR type of the phase
+  };
+
+  /**
+  *@brief satellite of a record (first 3 chars), resolved once
+  */
+  struct t_fastsat {
+    string                     sat;       // satellite
+    bool                       filter;    // satellite requested
+    const vector<t_fastfield>* fields;    // fields of the satellite system
+  };
+
+  bool                              _fast;         // decode the observation records directly from the buffer
+  map<int, t_fastsat>               _fastsat;      // satellites by the first 3 chars of the record
+  map<string, vector<t_fastfield> > _fastfields;   // fields by the system of _mapobs
    
 
  private:
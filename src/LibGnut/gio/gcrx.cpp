@@ -0,0 +1,305 @@
+/**
+ * @file         gcrx.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        compact RINEX (Hatanaka CRX 1.0/3.0) to RINEX observation decoder
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gio/gcrx.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+namespace gnut
+{
+	// columns of the epoch line: flag, number of satellites, satellite list
+	static const int CRX1_FLAG = 28, CRX1_NSAT = 29, CRX1_SATS = 32;
+	static const int CRX3_FLAG = 31, CRX3_NSAT = 32, CRX3_SATS = 41;
+
+	t_gcrx::t_gcrx() :
+		_state(CRX_VERS),
+		_version(0),
+		_nobs(0),
+		_flag('0'),
+		_nline(0),
+		_iline(0),
+		_iepoch(0)
+	{
+	}
+
+	t_gcrx::~t_gcrx()
+	{
+	}
+
+	int t_gcrx::decode(const char* line, int len, string& rnx)
+	{
+		// tolerate CR LF
+		if (len > 0 && line[len - 1] == '\r') len--;
+
+		switch (_state)
+		{
+		case CRX_VERS:
+			if (len < 71 || strncmp(line + 60, "CRINEX VERS", 11) != 0) return -1;
+			_version = (line[0] == '3') ? 3 : 1;
+			_state = CRX_PROG;
+			return 0;
+
+		case CRX_PROG:
+			_state = HEAD;
+			return 0;
+
+		case HEAD:
+			rnx.append(line, len);
+			rnx += '\n';
+			if (len > 60)
+			{
+				string label(line + 60, len - 60);
+				if (label.find("# / TYPES OF OBSERV") != string::npos && line[5] != ' ')
+				{
+					_nobs = atoi(string(line, 6).c_str());
+				}
+				else if (label.find("SYS / # / OBS TYPES") != string::npos && line[0] != ' ')
+				{
+					_nobs_sys[line[0]] = atoi(string(line + 3, 3).c_str());
+				}
+				else if (label.find("END OF HEADER") != string::npos)
+				{
+					_state = EPOCH;
+				}
+			}
+			return 0;
+
+		case EPOCH:
+			// initialized ('&' in CRX 1.0, '>' in CRX 3.0) or differenced against the last one
+			if (len > 0 && (line[0] == '&' || line[0] == '>')) _epoch.clear();
+			else if (_epoch.empty()) return -1;
+			_repair(_epoch, line, len);
+			if (_read_epoch() < 0) return -1;
+
+			// special events: lines passed through
+			if (_flag > '1' && _flag != '6')
+			{
+				int ncol = (_version == 3) ? CRX3_SATS - 6 : CRX1_SATS;
+				rnx.append(_epoch, 0, ncol);
+				while (!rnx.empty() && rnx[rnx.size() - 1] == ' ') rnx.erase(rnx.size() - 1);
+				rnx += '\n';
+				_iline = 0;
+				_state = (_nline > 0) ? EVENT : EPOCH;
+				return 0;
+			}
+			_state = CLOCK;
+			return 0;
+
+		case CLOCK:
+			if (_read_clock(line, len, rnx) < 0) return -1;
+			_iline = 0;
+			_state = (_nline > 0) ? DATA : EPOCH;
+			if (_state == EPOCH) _iepoch++;
+			return 0;
+
+		case DATA:
+			if (_read_data(line, len, rnx) < 0) return -1;
+			if (++_iline == _nline)
+			{
+				_iepoch++;
+				_state = EPOCH;
+			}
+			return 0;
+
+		case EVENT:
+			rnx.append(line, len);
+			rnx += '\n';
+			if (++_iline == _nline) _state = EPOCH;
+			return 0;
+		}
+
+		return -1;
+	}
+
+	int t_gcrx::_read_epoch()
+	{
+		int col_flag = (_version == 3) ? CRX3_FLAG : CRX1_FLAG;
+		int col_nsat = (_version == 3) ? CRX3_NSAT : CRX1_NSAT;
+		int col_sats = (_version == 3) ? CRX3_SATS : CRX1_SATS;
+		if ((int)_epoch.size() < col_nsat + 3) return -1;
+
+		_flag = _epoch[col_flag];
+		_nline = atoi(_epoch.substr(col_nsat, 3).c_str());
+		if (_nline < 0) return -1;
+		if (_flag > '1' && _flag != '6') return 0;
+
+		if ((int)_epoch.size() < col_sats + 3 * _nline) _epoch.resize(col_sats + 3 * _nline, ' ');
+		_sats.resize(_nline);
+		for (int i = 0; i < _nline; i++)
+		{
+			_sats[i].assign(_epoch, col_sats + 3 * i, 3);
+			// RINEX 2: blank system is GPS
+			if (_sats[i][0] == ' ') _sats[i][0] = 'G';
+		}
+
+		return 0;
+	}
+
+	int t_gcrx::_read_clock(const char* line, int len, string& rnx)
+	{
+		bool clock = (len > 0);
+		if (clock && _restore(_clock, line, len) < 0) return -1;
+		if (!clock) _clock.order = -1;
+
+		if (_version == 3)
+		{
+			rnx.append(_epoch, 0, CRX3_SATS - 6);
+			if (clock)
+			{
+				rnx.append(6, ' ');
+				_put_fixed(rnx, _clock.diff[0], 15, 12);
+			}
+			rnx += '\n';
+			return 0;
+		}
+
+		// RINEX 2: 12 satellites per line, clock offset in the first one
+		for (int i = 0; i < _nline || i == 0; i += 12)
+		{
+			if (i == 0) rnx.append(_epoch, 0, CRX1_SATS);
+			else        rnx.append(CRX1_SATS, ' ');
+			int nsat = (_nline - i < 12) ? _nline - i : 12;
+			if (nsat > 0) rnx.append(_epoch, CRX1_SATS + 3 * i, 3 * nsat);
+			if (i == 0 && clock)
+			{
+				rnx.append(12 - nsat > 0 ? 3 * (12 - nsat) : 0, ' ');
+				_put_fixed(rnx, _clock.diff[0], 12, 9);
+			}
+			rnx += '\n';
+		}
+
+		return 0;
+	}
+
+	int t_gcrx::_read_data(const char* line, int len, string& rnx)
+	{
+		const string& prn = _sats[_iline];
+		int nobs = _nobs;
+		if (_version == 3)
+		{
+			auto itSYS = _nobs_sys.find(prn[0]);
+			nobs = (itSYS == _nobs_sys.end()) ? 0 : itSYS->second;
+		}
+
+		// satellite not observed in the previous epoch: all arcs initialized again
+		t_gcrxsat& sat = _data[prn];
+		if (sat.epoch != _iepoch - 1 || (int)sat.arcs.size() != nobs)
+		{
+			sat.arcs.assign(nobs, t_gcrxarc());
+			sat.flags.clear();
+		}
+		sat.epoch = _iepoch;
+
+		// fields separated by a blank, the flags are the rest of the line
+		int pos = 0;
+		for (int j = 0; j < nobs; j++)
+		{
+			int beg = pos;
+			while (pos < len && line[pos] != ' ') pos++;
+			if (pos > beg)
+			{
+				if (_restore(sat.arcs[j], line + beg, pos - beg) < 0) return -1;
+			}
+			else sat.arcs[j].order = -1;
+			if (pos < len) pos++;
+		}
+		_repair(sat.flags, line + pos, len - pos);
+
+		// RINEX 3: satellite and all observations, RINEX 2: 5 observations per line
+		size_t line_beg = rnx.size();
+		if (_version == 3) rnx += prn;
+		for (int j = 0; j < nobs; j++)
+		{
+			if (sat.arcs[j].order >= 0) _put_fixed(rnx, sat.arcs[j].diff[0], 14, 3);
+			else rnx.append(14, ' ');
+			rnx += (2 * j < (int)sat.flags.size()) ? sat.flags[2 * j] : ' ';
+			rnx += (2 * j + 1 < (int)sat.flags.size()) ? sat.flags[2 * j + 1] : ' ';
+
+			if (_version != 3 && (j % 5 == 4 || j == nobs - 1))
+			{
+				while (rnx.size() > line_beg && rnx[rnx.size() - 1] == ' ') rnx.erase(rnx.size() - 1);
+				rnx += '\n';
+				line_beg = rnx.size();
+			}
+		}
+		if (_version == 3 || nobs == 0)
+		{
+			while (rnx.size() > line_beg && rnx[rnx.size() - 1] == ' ') rnx.erase(rnx.size() - 1);
+			rnx += '\n';
+		}
+
+		return 0;
+	}
+
+	int t_gcrx::_restore(t_gcrxarc& arc, const char* field, int len)
+	{
+		// initialization of the arc
+		if (len >= 2 && field[1] == '&')
+		{
+			if (field[0] < '0' || field[0] > '9') return -1;
+			arc.max_order = field[0] - '0';
+			arc.order = 0;
+			field += 2;
+			len -= 2;
+		}
+		else if (arc.order < 0) return -1;
+		else if (arc.order < arc.max_order) arc.order++;
+
+		bool neg = false;
+		if (len > 0 && (field[0] == '-' || field[0] == '+'))
+		{
+			neg = (field[0] == '-');
+			field++;
+			len--;
+		}
+		if (len <= 0) return -1;
+
+		long long val = 0;
+		for (int i = 0; i < len; i++)
+		{
+			if (field[i] < '0' || field[i] > '9') return -1;
+			val = val * 10 + (field[i] - '0');
+		}
+		if (neg) val = -val;
+
+		// value restored from the highest order difference
+		arc.diff[arc.order] = val;
+		for (int k = arc.order; k > 0; k--) arc.diff[k - 1] += arc.diff[k];
+
+		return 0;
+	}
+
+	void t_gcrx::_repair(string& str, const char* diff, int len)
+	{
+		int i = 0;
+		for (; i < len && i < (int)str.size(); i++)
+		{
+			if (diff[i] == ' ') continue;
+			str[i] = (diff[i] == '&') ? ' ' : diff[i];
+		}
+		for (; i < len; i++) str += (diff[i] == '&') ? ' ' : diff[i];
+	}
+
+	void t_gcrx::_put_fixed(string& rnx, long long val, int width, int dec)
+	{
+		static const long long pow10[] = { 1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+			100000000LL, 1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL };
+
+		unsigned long long abs_val = (val < 0) ? -(unsigned long long)val : (unsigned long long)val;
+		char buff[40];
+		int n = snprintf(buff, sizeof(buff), "%s%llu.%0*llu", (val < 0) ? "-" : "",
+			abs_val / pow10[dec], dec, abs_val % pow10[dec]);
+		if (n < width) rnx.append(width - n, ' ');
+		rnx.append(buff, n);
+	}
+
+} // namespace
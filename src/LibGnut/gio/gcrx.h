@@ -0,0 +1,116 @@
+/**
+ * @file         gcrx.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        compact RINEX (Hatanaka CRX 1.0/3.0) to RINEX observation decoder
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GCRX_H
+#define GCRX_H
+
+#include "gexport/ExportLibGnut.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace gnut
+{
+	/**
+	* @brief arc of one observation (or the receiver clock)
+	* @note  diff[0] is the value, diff[k] its k-th order difference
+	*/
+	struct t_gcrxarc
+	{
+		t_gcrxarc() : order(-1), max_order(0) {}
+
+		int order;             ///< current order of difference, -1 if not initialized
+		int max_order;         ///< order of difference of the arc
+		long long diff[10];    ///< value and its differences (in units of the last digit)
+	};
+
+	/**
+	* @brief observations of one satellite in the previous epoch
+	*/
+	struct t_gcrxsat
+	{
+		t_gcrxsat() : epoch(-1) {}
+
+		int               epoch;   ///< index of the epoch last observed
+		vector<t_gcrxarc> arcs;    ///< arcs of the observation types
+		string            flags;   ///< LLI and SSI flags
+	};
+
+	/**
+	* @brief compact RINEX to RINEX, line by line
+	* @note  the CRX header lines are removed, the RINEX header is passed through, the epoch lines,
+	*        clock offsets, observations and flags are restored from their differences
+	*        (Y. Hatanaka, A Compression Format and Tools for GNSS Observation Data, 2008)
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gcrx
+	{
+	public:
+		/** @brief default constructor */
+		t_gcrx();
+
+		/** @brief default destructor */
+		~t_gcrx();
+
+		/**
+		* @brief decode one CRX line
+		* @param[in]  line  line without the line end
+		* @param[in]  len   length of the line
+		* @param[out] rnx   RINEX lines are appended (with line ends)
+		* @return
+			@retval =0  decoded
+			@retval <0  not a compact RINEX or format error
+		*/
+		int decode(const char* line, int len, string& rnx);
+
+		/** @brief CRX version (1 or 3), 0 before the CRX header */
+		int version() const { return _version; }
+
+	private:
+		/** @brief read satellite list and flag of the epoch line */
+		int _read_epoch();
+
+		/** @brief receiver clock line, write the RINEX epoch line */
+		int _read_clock(const char* line, int len, string& rnx);
+
+		/** @brief observations of the next satellite */
+		int _read_data(const char* line, int len, string& rnx);
+
+		/** @brief restore an arc by the field "order&value" or "difference" */
+		static int _restore(t_gcrxarc& arc, const char* field, int len);
+
+		/** @brief restore the string by the differenced string ('&' = blank) */
+		static void _repair(string& str, const char* diff, int len);
+
+		/** @brief append value in units of the last of dec digits, right aligned in width */
+		static void _put_fixed(string& rnx, long long val, int width, int dec);
+
+		/** @brief decoding state */
+		enum t_state { CRX_VERS, CRX_PROG, HEAD, EPOCH, CLOCK, DATA, EVENT };
+
+		t_state              _state;     ///< decoding state
+		int                  _version;   ///< CRX version (1 or 3)
+		int                  _nobs;      ///< number of observation types (RINEX 2)
+		map<char, int>       _nobs_sys;  ///< number of observation types of each system (RINEX 3)
+		string               _epoch;     ///< epoch line (with all satellites)
+		char                 _flag;      ///< epoch flag
+		int                  _nline;     ///< satellites (or event lines) of the epoch
+		int                  _iline;     ///< next satellite (or event line)
+		int                  _iepoch;    ///< index of the data epoch
+		vector<string>       _sats;      ///< satellites of the epoch
+		t_gcrxarc            _clock;     ///< receiver clock offset
+		map<string, t_gcrxsat> _data;    ///< observations of the satellites
+	};
+
+} // namespace
+
+#endif // !GCRX_H
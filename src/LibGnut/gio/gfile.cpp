@@ -6,7 +6,9 @@
 -*/
 
 #include <cstring>
+#include <cctype>
 #include <sstream>
+#include <algorithm>
 
 #include "gio/gfile.h"
 #include "gutils/gcommon.h"
@@ -21,11 +23,13 @@ namespace gnut {
 t_gfile::t_gfile()
  : t_gio(),
    _irc(0),
-   _gzip(false)
+   _gzip(false),
+   _crx(false)
 {
   gtrace("t_gfile::construct");
   
   _file  = 0;
+  _inflate = 0;
   _size = FILEBUF_SIZE;
 }
 
@@ -77,6 +81,13 @@ int t_gfile::path( string str )
         return -1;
     }
 
+    // decompressed on the fly, in large chunks
+    if (_gzip || _crx)
+    {
+        _inflate = new t_ginflate(_file, _gzip, _crx);
+        _size = INFLATE_CHUNK;
+    }
+
     ostringstream ltmp; 
     ltmp << "File: " << int(idx1) << ":" << int(idx2) << " = " << name;
     if( _log ) _log->comment(3, "gfile", ltmp.str());
@@ -110,6 +121,7 @@ string t_gfile::name(){
 // ----------
 int t_gfile::irc()const
 {
+    if (_file && _inflate) return (_file->irc() + _inflate->irc() + _irc);
     if (_file) return (_file->irc() + _irc);
 
     return _irc;
@@ -119,6 +131,9 @@ int t_gfile::irc()const
 // ----------
 bool t_gfile::eof()
 {
+    if (_inflate)
+        return _inflate->eof();
+
     if (_file)
         return _file->eof();
 
@@ -202,6 +217,7 @@ void t_gfile::reset()
 {
     gtrace("t_gfile::reset");
 
+    if (_inflate) { delete _inflate;   _inflate = 0; }
     if (_file) { delete _file;   _file = 0; }
 }
 
@@ -258,11 +274,23 @@ void t_gfile::_set_gzip( string name )
   gtrace("t_gfile::_set_gzip");
 
   if( // name.compare(name.length()-2,name.length(),".Z")  == 0 || ///  NOT SUPPORTED
-      name.compare(name.length()-3,name.length(),".gz") == 0 )
+      name.length() > 3 && name.compare(name.length()-3,name.length(),".gz") == 0 )
 
         _gzip = true;
    else _gzip = false;
 
+  // compact RINEX: long name .crx, short name .yyd
+  string base = base_name( _gzip ? name.substr(0, name.length()-3) : name );
+  size_t ext  = base.find_last_of(".");
+  string sfx  = ( ext == string::npos ) ? "" : base.substr(ext+1);
+  transform(sfx.begin(), sfx.end(), sfx.begin(), ::tolower);
+
+  if( sfx == "crx" ||
+     ( sfx.length() == 3 && isdigit(sfx[0]) && isdigit(sfx[1]) && sfx[2] == 'd' ) )
+
+        _crx = true;
+   else _crx = false;
+
 }
 
 
@@ -271,6 +299,9 @@ int t_gfile::_read( char* b, int s )
 {
   gtrace("t_gfile::_read");
 
+  if (_inflate)
+      return _inflate->read(b, s);
+
   if (_file)
       return _file->read(b, s);
 
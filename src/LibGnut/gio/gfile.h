@@ -26,6 +26,7 @@
 
 #include "gio/gio.h"
 #include "gio/giof.h"
+#include "gio/ginflate.h"
 
 // special buffer size for file reading
 // --> must be bellow gcoder maximum limit !
@@ -52,6 +53,7 @@ namespace gnut {
          virtual string mask();                    // integrate gzip/ascii
          
          virtual bool compressed(){ return _gzip; }
+         virtual bool hatanaka(){ return _crx; }   // compact RINEX
          
          virtual int path( string str );           // set/get file://dir/name
          virtual string path();
@@ -81,7 +83,7 @@ namespace gnut {
         */
          virtual int _stop_common();
          /**
-        * @brief compressed or not ?
+        * @brief compressed or not ? (gzip: .gz, compact RINEX: .crx, .yyd)
         * @param[in]    name    file name
         */
          virtual void _set_gzip( string name );
@@ -104,7 +106,9 @@ namespace gnut {
 
          int         _irc;
          bool        _gzip;                        // compressed
+         bool        _crx;                         // compact RINEX (Hatanaka)
          t_giof*     _file;                        // ascii file
+         t_ginflate* _inflate;                     // decompression of _file
      private:
     };
 
@@ -0,0 +1,232 @@
+/**
+ * @file         ginflate.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        streaming decompression of gzip and compact RINEX files
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gio/ginflate.h"
+#include "gutils/gcommon.h"
+
+#include <cstring>
+
+namespace gnut
+{
+	t_ginflate::t_ginflate(t_giof* file, bool gzip, bool crx, bool threaded) :
+		_file(file),
+		_gzip(gzip),
+		_crx(crx),
+		_threaded(threaded),
+		_irc(0),
+		_zinit(false),
+		_zend(false),
+		_zmember(false),
+		_started(false),
+		_done(false),
+		_stop(false),
+		_pos(0)
+	{
+		gtrace("t_ginflate::construct");
+
+		memset(&_zs, 0, sizeof(_zs));
+		if (_gzip)
+		{
+			// automatic gzip/zlib header detection
+			if (inflateInit2(&_zs, 15 + 32) == Z_OK) _zinit = true;
+			else _irc++;
+		}
+	}
+
+	t_ginflate::~t_ginflate()
+	{
+		gtrace("t_ginflate::destruct");
+
+		if (_started)
+		{
+			{
+				lock_guard<mutex> lock(_mutex);
+				_stop = true;
+			}
+			_cond.notify_all();
+			_worker.join();
+		}
+		if (_zinit) inflateEnd(&_zs);
+	}
+
+	int t_ginflate::read(char* buff, int size)
+	{
+		gtrace("t_ginflate::read");
+
+		if (size <= 0) return 0;
+
+		if (_pos >= _chunk.size())
+		{
+			_chunk.clear();
+			_pos = 0;
+
+			if (!_threaded)
+			{
+				if (!_done && _produce(_chunk) <= 0) _done = true;
+			}
+			else
+			{
+				if (!_started)
+				{
+					_started = true;
+					_worker = thread(&t_ginflate::_run, this);
+				}
+
+				unique_lock<mutex> lock(_mutex);
+				_cond.wait(lock, [this] { return !_queue.empty() || _done; });
+				if (!_queue.empty())
+				{
+					_chunk.swap(_queue.front());
+					_queue.pop_front();
+				}
+				lock.unlock();
+				_cond.notify_all();
+			}
+
+			if (_chunk.empty()) return (_irc > 0) ? -1 : 0;
+		}
+
+		int nbytes = (int)min((size_t)size, _chunk.size() - _pos);
+		memcpy(buff, _chunk.data() + _pos, nbytes);
+		_pos += nbytes;
+		return nbytes;
+	}
+
+	bool t_ginflate::eof()
+	{
+		if (_pos < _chunk.size()) return false;
+
+		lock_guard<mutex> lock(_mutex);
+		return _done && _queue.empty();
+	}
+
+	void t_ginflate::_run()
+	{
+		while (true)
+		{
+			string chunk;
+			int nbytes = _produce(chunk);
+
+			unique_lock<mutex> lock(_mutex);
+			if (nbytes <= 0 || _stop)
+			{
+				_done = true;
+				lock.unlock();
+				_cond.notify_all();
+				return;
+			}
+
+			_cond.wait(lock, [this] { return _queue.size() < INFLATE_QUEUE || _stop; });
+			if (_stop)
+			{
+				_done = true;
+				return;
+			}
+			_queue.push_back(move(chunk));
+			lock.unlock();
+			_cond.notify_all();
+		}
+	}
+
+	int t_ginflate::_produce(string& chunk)
+	{
+		chunk.clear();
+		if (_irc > 0) return 0;
+		chunk.reserve(INFLATE_CHUNK + 4096);
+		if (_inf.empty()) _inf.resize(INFLATE_CHUNK);
+
+		while (chunk.size() < INFLATE_CHUNK)
+		{
+			int nbytes = _inflate(_inf.data(), (int)_inf.size());
+			if (nbytes < 0) { _irc++; break; }
+
+			if (!_crx)
+			{
+				if (nbytes == 0) break;
+				chunk.append(_inf.data(), nbytes);
+				continue;
+			}
+
+			// complete CRX lines restored to RINEX, the last line may be without line end
+			const char* beg = _inf.data();
+			const char* end = beg + nbytes;
+			while (beg < end || (nbytes == 0 && !_line.empty()))
+			{
+				const char* eol = (const char*)memchr(beg, '\n', end - beg);
+				if (!eol && nbytes > 0)
+				{
+					_line.append(beg, end - beg);
+					break;
+				}
+				if (eol) _line.append(beg, eol - beg);
+				if (_gcrx.decode(_line.data(), (int)_line.size(), chunk) < 0)
+				{
+					_irc++;
+					_line.clear();
+					return (int)chunk.size();
+				}
+				_line.clear();
+				beg = eol ? eol + 1 : end;
+			}
+			if (nbytes == 0) break;
+		}
+
+		return (int)chunk.size();
+	}
+
+	int t_ginflate::_inflate(char* buff, int size)
+	{
+		if (!_gzip)
+		{
+			if (_zend) return 0;
+			int nbytes = _file->read(buff, size);
+			if (nbytes <= 0) { _zend = true; return (nbytes < 0) ? -1 : 0; }
+			return nbytes;
+		}
+		if (!_zinit) return -1;
+
+		if (_raw.empty()) _raw.resize(INFLATE_CHUNK);
+		_zs.next_out = (Bytef*)buff;
+		_zs.avail_out = size;
+
+		while (_zs.avail_out == (uInt)size)
+		{
+			if (_zs.avail_in == 0)
+			{
+				if (_zend) return 0;
+				int nbytes = _file->read(_raw.data(), (int)_raw.size());
+				if (nbytes <= 0)
+				{
+					// truncated gzip member
+					_zend = true;
+					return _zmember ? -1 : 0;
+				}
+				_zs.next_in = (Bytef*)_raw.data();
+				_zs.avail_in = nbytes;
+				_zmember = true;
+			}
+
+			int irc = ::inflate(&_zs, Z_NO_FLUSH);
+			if (irc == Z_STREAM_END)
+			{
+				// concatenated gzip members
+				if (inflateReset(&_zs) != Z_OK) return -1;
+				_zmember = (_zs.avail_in > 0);
+			}
+			else if (irc != Z_OK && irc != Z_BUF_ERROR)
+			{
+				return -1;
+			}
+		}
+
+		return size - _zs.avail_out;
+	}
+
+} // namespace
@@ -0,0 +1,110 @@
+/**
+ * @file         ginflate.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        streaming decompression of gzip and compact RINEX files
+ * @version      1.0
+ * @date         2024-08-29
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GINFLATE_H
+#define GINFLATE_H
+
+#include "gexport/ExportLibGnut.h"
+#include "gio/giof.h"
+#include "gio/gcrx.h"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include <zlib.h>
+
+// decompressed chunk handed to the decoder and chunks queued ahead
+#define INFLATE_CHUNK   262144
+#define INFLATE_QUEUE        8
+
+using namespace std;
+
+namespace gnut
+{
+	/**
+	* @brief file content inflated (gzip) and/or restored from compact RINEX on the fly
+	* @note  no temporary files, the chunks are produced in a worker thread while the
+	*        previous ones are decoded (or in the reading thread if not threaded)
+	*/
+	class LibGnut_LIBRARY_EXPORT t_ginflate
+	{
+	public:
+		/**
+		* @brief constructor
+		* @param[in] file     compressed file, not owned
+		* @param[in] gzip     gzip (or zlib) compressed
+		* @param[in] crx      compact RINEX (Hatanaka)
+		* @param[in] threaded decompress in a worker thread
+		*/
+		t_ginflate(t_giof* file, bool gzip, bool crx, bool threaded = true);
+
+		/** @brief default destructor, stops the worker thread */
+		~t_ginflate();
+
+		/**
+		* @brief read decompressed data
+		* @return
+			@retval >0  number of bytes read
+			@retval =0  end of data
+			@retval <0  fail
+		*/
+		int read(char* buff, int size);
+
+		/** @brief all data read */
+		bool eof();
+
+		/** @brief error status */
+		int irc() const { return _irc; }
+
+	private:
+		/** @brief next decompressed chunk, empty at the end of data */
+		int _produce(string& chunk);
+
+		/** @brief raw or inflated bytes of the file, 0 at the end of file */
+		int _inflate(char* buff, int size);
+
+		/** @brief worker thread */
+		void _run();
+
+		t_giof*      _file;          ///< compressed file
+		bool         _gzip;          ///< gzip compressed
+		bool         _crx;           ///< compact RINEX
+		bool         _threaded;      ///< worker thread used
+		int          _irc;           ///< error status
+
+		z_stream     _zs;            ///< zlib stream
+		bool         _zinit;         ///< zlib stream initialized
+		bool         _zend;          ///< end of the compressed file
+		bool         _zmember;       ///< inside of a gzip member
+		vector<char> _raw;           ///< compressed bytes
+		vector<char> _inf;           ///< inflated bytes
+
+		t_gcrx       _gcrx;          ///< compact RINEX decoder
+		string       _line;          ///< incomplete CRX line
+
+		thread       _worker;        ///< worker thread
+		mutex        _mutex;         ///< guards the queue
+		condition_variable _cond;    ///< queue changed
+		deque<string> _queue;        ///< chunks produced
+		bool         _started;       ///< worker started
+		bool         _done;          ///< all chunks produced
+		bool         _stop;          ///< worker to be stopped
+
+		string       _chunk;         ///< chunk being read
+		size_t       _pos;           ///< read position in the chunk
+	};
+
+} // namespace
+
+#endif // !GINFLATE_H
@@ -17,6 +17,19 @@
 
 #include "giobigf.h"
 #include <assert.h>
+#include <cstring>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace gnut
 {
@@ -24,13 +37,20 @@ namespace gnut
 		:t_giof(mask),
 		buffer_size(buffer_size),
 		_current(0),
-		_buffer(nullptr)
+		_buffer(nullptr),
+		_flushed(0)
 	{
 		_buffer = new char[buffer_size];
 	}
 
 	t_giobigf::~t_giobigf()
 	{
+		_stop_async();
+		if (_async) {
+			for (auto buff : _pool) delete[] buff;
+			_pool.clear();
+			_buffer = nullptr;
+		}
 		if (_buffer) {
 			delete[] _buffer;
 			_buffer = nullptr;
@@ -39,11 +59,31 @@ namespace gnut
 
 	int t_giobigf::write(const char * buff, int size)
 	{
+		if (_async) {
+			// split into the buffers, never write in the caller thread
+			const char* src = buff;
+			int left = size;
+			while (left > 0) {
+				if (_current == buffer_size && _submit() < 0) {
+					return -1;
+				}
+				int len = min(left, buffer_size - _current);
+				memcpy(&this->_buffer[_current], src, len);
+				_current += len;
+				src += len;
+				left -= len;
+			}
+			_total += size;
+			return size;
+		}
+
 		if (_current + size > buffer_size) {
 			//this->flush();
 			if (this->flush() < 0) {
 				return -1;
 			}
+			_total += size;
+			_flushed += size;
 			return (t_giof::write(buff, size));
 		}
 
@@ -53,11 +93,20 @@ namespace gnut
 
 		memcpy(&this->_buffer[_current], buff, size);
 		_current += size;
+		_total += size;
 		return size;
 	}
 
 	int t_giobigf::flush()
 	{
+		if (_async) {
+			if (_current > 0 && _submit() < 0) {
+				return -1;
+			}
+
+			return _wait_async();
+		}
+
 		if (_current == 0) {
 			return 0;
 		}
@@ -66,11 +115,319 @@ namespace gnut
 		if (state < 0) {
 			return state;
 		}
+		_flushed += _current;
 		_current = 0;
 		return state;
 		//return (t_giof::write(_buffer, _current));
 	}
 
+	int t_giobigf::start_async(int num_buffer)
+	{
+		if (_async) {
+			return 0;
+		}
+		if (num_buffer < 2 || this->flush() < 0) {
+			return -1;
+		}
+
+		_pool.push_back(_buffer);
+		for (int i = 1; i < num_buffer; i++) {
+			char* buff = new char[buffer_size];
+			_pool.push_back(buff);
+			_free.push_back(buff);
+		}
+		_stop = false;
+		_error = false;
+		_async = true;
+		_io_thread = thread(&t_giobigf::_run_async, this);
+		return 0;
+	}
+
+	void t_giobigf::close()
+	{
+		// as in sync mode, the current buffer is not flushed by close
+		if (_async) {
+			_wait_async();
+		}
+		fstream::close();
+	}
+
+	int t_giobigf::_submit()
+	{
+		auto beg = chrono::steady_clock::now();
+		unique_lock<std::mutex> lock(_async_mutex);
+		_full.push_back(make_pair(_buffer, _current));
+		_cv_full.notify_one();
+
+		_cv_free.wait(lock, [this] { return !_free.empty() || _error; });
+		_stall_time += chrono::duration<double>(chrono::steady_clock::now() - beg).count();
+		if (_error) {
+			return -1;
+		}
+		_buffer = _free.front();
+		_free.pop_front();
+		_current = 0;
+		return 0;
+	}
+
+	int t_giobigf::_wait_async()
+	{
+		auto beg = chrono::steady_clock::now();
+		unique_lock<std::mutex> lock(_async_mutex);
+		_cv_free.wait(lock, [this] { return _full.empty() || _error; });
+		_stall_time += chrono::duration<double>(chrono::steady_clock::now() - beg).count();
+		return _error ? -1 : 0;
+	}
+
+	void t_giobigf::_stop_async()
+	{
+		if (!_io_thread.joinable()) {
+			return;
+		}
+		_wait_async();
+		{
+			lock_guard<std::mutex> lock(_async_mutex);
+			_stop = true;
+		}
+		_cv_full.notify_one();
+		_io_thread.join();
+	}
+
+	void t_giobigf::_run_async()
+	{
+		unique_lock<std::mutex> lock(_async_mutex);
+		while (true) {
+			_cv_full.wait(lock, [this] { return !_full.empty() || _stop; });
+			if (_full.empty()) {
+				break;
+			}
+
+			// the buffer stays in _full until written, so flush() can wait for it
+			pair<char*, int> job = _full.front();
+			lock.unlock();
+			int state = job.second > 0 ? t_giof::write(job.first, job.second) : 0;
+			lock.lock();
+
+			_full.pop_front();
+			if (state < 0) {
+				_error = true;
+			}
+			else {
+				_flushed += job.second;
+			}
+			_free.push_back(job.first);
+			_cv_free.notify_all();
+		}
+	}
+
+
+	t_giotemp::t_giotemp(string mask, int buffer_size)
+		:t_giobigf(mask, buffer_size),
+		_index(nullptr),
+		_num_record(0)
+	{
+		memset(&_record, 0, sizeof(_record));
+		_record.offset = -1;
+	}
+
+	t_giotemp::~t_giotemp()
+	{
+		if (_index) {
+			if (_index->is_open()) _index->close();
+			delete _index;
+			_index = nullptr;
+		}
+	}
+
+	int t_giotemp::open_temp(const string& filename)
+	{
+		this->open(filename, ios::out | ios::trunc | ios::binary);
+
+		string index_name = filename + ".idx";
+		if (_index) delete _index;
+		_index = new t_giobigf(index_name, 1024 * 1000);
+		_index->tsys(t_gtime::GPS);
+		_index->mask(index_name);
+		_index->append(false);
+		_index->open(index_name, ios::out | ios::trunc | ios::binary);
+		_num_record = 0;
+
+		if (!this->is_open() || !_index->is_open()) {
+			return -1;
+		}
+
+		t_gtempheader header;
+		memset(&header, 0, sizeof(header));
+		strncpy(header.magic, TEMPFILE_MAGIC, sizeof(header.magic));
+		header.version = TEMPFILE_VERSION;
+		return this->write((char*)&header, sizeof(header));
+	}
+
+	void t_giotemp::record_begin(const char* type)
+	{
+		assert(_record.offset < 0);
+		_record.offset = bytes_written();
+		memcpy(_record.type, type, 3);
+		_record.type[3] = '\0';
+		this->write(type, 3);
+	}
+
+	void t_giotemp::record_end()
+	{
+		assert(_record.offset >= 0);
+		_record.length = (int32_t)(bytes_written() - _record.offset);
+		_index->write((char*)&_record, sizeof(_record));
+		_record.offset = -1;
+		_num_record++;
+	}
+
+	int t_giotemp::finalize()
+	{
+		if (!_index) {
+			return -1;
+		}
+
+		t_gtempheader footer;
+		memset(&footer, 0, sizeof(footer));
+		strncpy(footer.magic, TEMPINDEX_MAGIC, sizeof(footer.magic));
+		footer.version = TEMPFILE_VERSION;
+		footer.num_record = _num_record;
+		footer.data_size = bytes_written();
+		_index->write((char*)&footer, sizeof(footer));
+
+		int state = 0;
+		if (this->flush() < 0 || _index->flush() < 0) {
+			state = -1;
+		}
+		if (this->is_open()) this->close();
+		if (_index->is_open()) _index->close();
+		return state;
+	}
+
+	t_gtemprecord::t_gtemprecord(const char* beg, const char* end) :
+		_current(beg),
+		_end(end)
+	{
+	}
+
+	void t_gtemprecord::read(char* dst, int size)
+	{
+		assert(size > 0);
+		if (_current + size > _end) {
+			throw runtime_error("Read tempfile Wrong!!!");
+		}
+		memcpy(dst, _current, size);
+		_current += size;
+	}
+
+	void t_gtemprecord::skip(int size)
+	{
+		if (size < 0 || _current + size > _end) {
+			throw runtime_error("Read tempfile Wrong!!!");
+		}
+		_current += size;
+	}
+
+	t_gmmapfile::t_gmmapfile(const string& filename) :
+		_data(nullptr),
+		_size(0)
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		_file = nullptr;
+		_mapping = nullptr;
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw runtime_error("Open tempfile " + filename + " is wrong!");
+		}
+		_file = file;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			throw runtime_error("Get tempfile filesize is wrong!");
+		}
+		_size = size.QuadPart;
+		if (_size > 0) {
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping == NULL) {
+				CloseHandle(file);
+				throw runtime_error("Map tempfile " + filename + " is wrong!");
+			}
+			_mapping = mapping;
+			_data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		}
+#else
+		_fd = ::open(filename.c_str(), O_RDONLY);
+		if (_fd < 0) {
+			throw runtime_error("Open tempfile " + filename + " is wrong!");
+		}
+		struct stat st;
+		if (fstat(_fd, &st) != 0) {
+			::close(_fd);
+			throw runtime_error("Get tempfile filesize is wrong!");
+		}
+		_size = st.st_size;
+		if (_size > 0) {
+			void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+			if (data == MAP_FAILED) {
+				::close(_fd);
+				throw runtime_error("Map tempfile " + filename + " is wrong!");
+			}
+			_data = (const char*)data;
+		}
+#endif
+	}
+
+	t_gmmapfile::~t_gmmapfile()
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		if (_data) UnmapViewOfFile(_data);
+		if (_mapping) CloseHandle((HANDLE)_mapping);
+		if (_file) CloseHandle((HANDLE)_file);
+#else
+		if (_data) munmap((void*)_data, _size);
+		if (_fd >= 0) ::close(_fd);
+#endif
+	}
+
+	t_gmaptemp::t_gmaptemp(const string& tempfilename, const string& indexfilename) :
+		_data(tempfilename),
+		_index_file(indexfilename),
+		_index(nullptr),
+		_num_record(0)
+	{
+		// check the header of data and the footer of index
+		t_gtempheader header, footer;
+		if (_data.size() < (int64_t)sizeof(header) || _index_file.size() < (int64_t)sizeof(footer)) {
+			throw runtime_error("Tempfile is not complete!");
+		}
+		memcpy(&header, _data.data(), sizeof(header));
+		memcpy(&footer, _index_file.data() + _index_file.size() - sizeof(footer), sizeof(footer));
+		if (strncmp(header.magic, TEMPFILE_MAGIC, sizeof(header.magic)) != 0 ||
+			strncmp(footer.magic, TEMPINDEX_MAGIC, sizeof(footer.magic)) != 0) {
+			throw runtime_error("Tempfile format is wrong!");
+		}
+		if (header.version != TEMPFILE_VERSION || footer.version != TEMPFILE_VERSION) {
+			throw runtime_error("Tempfile version is not supported!");
+		}
+		if (footer.data_size != _data.size() ||
+			footer.num_record * (int64_t)sizeof(t_gtempindex) + (int64_t)sizeof(footer) != _index_file.size()) {
+			throw runtime_error("Tempfile is not complete!");
+		}
+
+		_index = (const t_gtempindex*)_index_file.data();
+		_num_record = footer.num_record;
+	}
+
+	t_gtemprecord t_gmaptemp::record(int64_t i) const
+	{
+		assert(i >= 0 && i < _num_record);
+		const t_gtempindex& index = _index[i];
+		if (index.offset < 0 || index.length < 3 || index.offset + index.length > _data.size()) {
+			throw runtime_error("Read tempfile Wrong!!!");
+		}
+		const char* beg = _data.data() + index.offset;
+		return t_gtemprecord(beg + 3, beg + index.length);
+	}
 
 	t_greadtemp::t_greadtemp(string tempfilename) :
 		_tmpfile(fopen(tempfilename.c_str(), "rb")),
@@ -20,9 +20,20 @@
 
 
 #include "gio/giof.h"
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
 
 #define MAX_BUFFER_SIZE 204800000
 
+#define TEMPFILE_VERSION 2            ///< version of the indexed tempfile format
+#define TEMPFILE_MAGIC   "GLSQTMP"    ///< magic of the tempfile header
+#define TEMPINDEX_MAGIC  "GLSQIDX"    ///< magic of the index footer
+
 namespace gnut
 {
 	/** @brief class for t_giobigf. */
@@ -35,12 +46,117 @@ namespace gnut
 
 		int write(const char* buff, int size) override;
 		int flush();
+
+		/**
+		* @brief write the full buffers in a background thread
+		* @param[in] num_buffer number of buffers (>=2) of buffer_size
+		* @return 0 if started, -1 otherwise
+		* @note write() only copies into the current buffer and hands it to the
+		*       I/O thread when full, it waits only when all buffers are in flight.
+		*       flush() returns after all the buffers are written to the file.
+		*/
+		int start_async(int num_buffer = 2);
+
+		/** @brief async writing is started */
+		bool is_async() const { return _async; }
+
+		/** @brief close the file, buffers in flight are written first */
+		void close();
+
+		/** @brief bytes written since construction (buffered included) */
+		int64_t bytes_written() const { return _total; }
+
+		/** @brief bytes already written to the file */
+		int64_t bytes_flushed() const { return _flushed; }
+
+		/** @brief time [s] the writer waited for a free buffer or for flush */
+		double stall_time() const { return _stall_time; }
 		
 		const int buffer_size;
 
 	private:
+		/** @brief hand the current buffer to the I/O thread and take a free one */
+		int _submit();
+
+		/** @brief wait until the buffers handed to the I/O thread are written */
+		int _wait_async();
+
+		/** @brief stop the I/O thread after the pending buffers are written */
+		void _stop_async();
+
+		/** @brief loop of the I/O thread */
+		void _run_async();
+
 		char* _buffer;
 		int _current;
+		int64_t _total = 0;
+
+		bool _async = false;                        ///< background writing
+		bool _stop = false;                         ///< ask the I/O thread to finish
+		bool _error = false;                        ///< write failed in the I/O thread
+		double _stall_time = 0.0;                   ///< time [s] waited by the writer
+		atomic<int64_t> _flushed;                   ///< bytes written to the file
+		vector<char*> _pool;                        ///< buffers allocated for async
+		deque<char*> _free;                         ///< buffers ready to be filled
+		deque<pair<char*, int> > _full;             ///< buffers waiting for the file (front in writing)
+		std::mutex _async_mutex;
+		condition_variable _cv_full;
+		condition_variable _cv_free;
+		thread _io_thread;
+	};
+
+	/** @brief fixed-size index entry of a tempfile record */
+	struct t_gtempindex
+	{
+		int64_t offset;     ///< offset of the record in the data file
+		int32_t length;     ///< length of the record (identifier included)
+		char    type[4];    ///< identifier of the record
+	};
+
+	/** @brief header of the data file and footer of the index file */
+	struct t_gtempheader
+	{
+		char    magic[8];    ///< TEMPFILE_MAGIC / TEMPINDEX_MAGIC
+		int32_t version;     ///< TEMPFILE_VERSION
+		int32_t reserved;
+		int64_t num_record;  ///< number of records (footer only)
+		int64_t data_size;   ///< size of the data file (footer only)
+	};
+
+	/**
+	* @brief tempfile with records indexed in a sidecar file
+	* @note data file : header + records (3 char identifier + payload)
+	*       index file: t_gtempindex of each record + footer
+	*/
+	class LibGnut_LIBRARY_EXPORT t_giotemp :public t_giobigf
+	{
+	public:
+		/** @brief default constructor. */
+		t_giotemp(string mask = "", int buffer_size = 1024 * 1000 * 10);
+		virtual ~t_giotemp();
+
+		/** @brief open the data and the index file and write the header */
+		int open_temp(const string& filename);
+
+		/** @brief start a record, the identifier (3 char) is written */
+		void record_begin(const char* type);
+
+		/** @brief finish the record started by record_begin */
+		void record_end();
+
+		/** @brief write the footer and close both files */
+		int finalize();
+
+		/** @brief name of the index file */
+		string index_name() const { return _index ? _index->name() : string(); }
+
+		/** @brief number of records written */
+		int64_t num_record() const { return _num_record; }
+
+	private:
+		t_giobigf* _index;
+		t_gtempindex _record;
+		int64_t _num_record;
 	};
 
 	class LibGnut_LIBRARY_EXPORT t_greadtemp
@@ -63,6 +179,73 @@ namespace gnut
 		int64_t _filesize;
 	};
 
+	/** @brief zero-copy cursor over one record of a mapped tempfile */
+	class LibGnut_LIBRARY_EXPORT t_gtemprecord
+	{
+	public:
+		t_gtemprecord(const char* beg, const char* end);
+
+		void read(char* dst, int size);
+
+		/** @brief move forward without copy */
+		void skip(int size);
+
+		/** @brief current position in the mapped file */
+		const char* data() const { return _current; }
+
+	private:
+		const char* _current;
+		const char* _end;
+	};
+
+	/** @brief read-only memory map of a file */
+	class LibGnut_LIBRARY_EXPORT t_gmmapfile
+	{
+	public:
+		t_gmmapfile(const string& filename);
+		~t_gmmapfile();
+
+		const char* data() const { return _data; }
+		int64_t size() const { return _size; }
+
+	private:
+		t_gmmapfile(const t_gmmapfile&);
+		t_gmmapfile& operator=(const t_gmmapfile&);
+
+		const char* _data;
+		int64_t _size;
+#if defined(_WIN32) || defined(_WIN64)
+		void* _file;
+		void* _mapping;
+#else
+		int _fd;
+#endif
+	};
+
+	/**
+	* @brief reader of t_giotemp, records are accessed directly by the index
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gmaptemp
+	{
+	public:
+		t_gmaptemp(const string& tempfilename, const string& indexfilename);
+
+		/** @brief number of records */
+		int64_t num_record() const { return _num_record; }
+
+		/** @brief identifier of the record i (3 char, not null terminated) */
+		const char* type(int64_t i) const { return _index[i].type; }
+
+		/** @brief record i, the cursor is behind the identifier */
+		t_gtemprecord record(int64_t i) const;
+
+	private:
+		t_gmmapfile _data;
+		t_gmmapfile _index_file;
+		const t_gtempindex* _index;
+		int64_t _num_record;
+	};
+
 
 }
 
@@ -0,0 +1,218 @@
+/**
+ * @file         gtail.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        file io following a growing file, a FIFO or a directory of files
+ * @version      1.0
+ * @date         2024-10-17
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gio/gtail.h"
+#include "gio/gfile.h"
+#include "gcoders/rinexo.h"
+#include "gutils/gcommon.h"
+#include "gutils/gfileconv.h"
+
+#include <chrono>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace gnut
+{
+	t_gtail::t_gtail() :
+		t_gio(),
+		_dir(false),
+		_head(false),
+		_idle(600.0),
+		_queue(nullptr),
+		_rinexo(nullptr),
+		_reported(0, 0)
+	{
+		gtrace("t_gtail::construct");
+
+		_size = TAIL_SIZE;
+	}
+
+	t_gtail::~t_gtail()
+	{
+		gtrace("t_gtail::destruct");
+
+		if (_is.is_open()) _is.close();
+	}
+
+	int t_gtail::path(string str)
+	{
+		gtrace("t_gtail::path(str)");
+
+		if (str.find(GFILE_PREFIX) == 0) str = str.substr(string(GFILE_PREFIX).length());
+		if (str.empty()) return -1;
+
+		while (str.size() > 1 && (str[str.size() - 1] == '/' || str[str.size() - 1] == '\\')) str.erase(str.size() - 1);
+		_name = str;
+		_dir = chk_directory(str);
+
+		return t_gio::path(str);
+	}
+
+	void t_gtail::coder(t_gcoder* coder)
+	{
+		_coder = coder;
+		_rinexo = dynamic_cast<t_rinexo*>(coder);
+	}
+
+	void t_gtail::queue(t_gepochqueue* queue)
+	{
+		_queue = queue;
+		if (_queue) _queue->add_source(_path);
+	}
+
+	int t_gtail::init_read()
+	{
+		gtrace("t_gtail::init_read");
+
+		if (!_coder) return 0;
+
+		char* loc_buff = new char[FILEHDR_SIZE];
+		int nbytes = 0;
+		while (!_head && (nbytes = _gio_read(loc_buff, FILEHDR_SIZE)) > 0) _decode(loc_buff, nbytes);
+		delete[] loc_buff;
+
+		if (!_head && _log) _log->comment(0, "gtail", "warning - header not completed: " + _path);
+		return _opened = (_head ? 1 : 0);
+	}
+
+	void t_gtail::run_read()
+	{
+		gtrace("t_gtail::run_read");
+
+		_gmutex.lock();
+
+		// the coder is not cleared, the header may be read before the data
+		if (!_opened) init_read();
+
+		char* loc_buff = new char[_size];
+		int nbytes = 0;
+		_running = 1;
+		while (_stop != 1 && (nbytes = _gio_read(loc_buff, _head ? (int)_size : FILEHDR_SIZE)) > 0)
+		{
+			_locf_write(loc_buff, nbytes);
+			_decode(loc_buff, nbytes);
+			_report();
+		}
+
+		if (_queue) _queue->finish(_path);
+		if (_log) _log->comment(2, "gtail", "end of the data: " + _path);
+
+		_stop_common();
+		delete[] loc_buff;
+		_gmutex.unlock();
+	}
+
+	int t_gtail::_gio_read(char* buff, int size)
+	{
+		chrono::steady_clock::time_point beg = chrono::steady_clock::now();
+		while (_stop != 1)
+		{
+			if (_is.is_open())
+			{
+				// the end of file is cleared, the data appended meanwhile are read
+				_is.clear();
+				_is.read(buff, size);
+				int nbytes = (int)_is.gcount();
+				if (nbytes > 0) return nbytes;
+			}
+
+			// nothing new, a directory continues by the next file
+			if ((!_is.is_open() || _dir) && _next_file()) continue;
+
+			if (chrono::duration<double>(chrono::steady_clock::now() - beg).count() > _idle) break;
+			t_gtime::gmsleep(TAIL_POLL);
+		}
+		return -1;
+	}
+
+	bool t_gtail::_next_file()
+	{
+		if (!_dir)
+		{
+			if (_is.is_open()) return false;
+			_is.open(_name.c_str(), ios::in | ios::binary);
+			if (!_is.is_open()) return false;
+			_file = _name;
+			_head = false;
+			return true;
+		}
+
+		// the first file (by name) after the current one
+		vector<string> names;
+#ifdef _WIN32
+		WIN32_FIND_DATAA data;
+		HANDLE handle = FindFirstFileA((_name + "\\*").c_str(), &data);
+		if (handle != INVALID_HANDLE_VALUE)
+		{
+			do
+			{
+				if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) names.push_back(data.cFileName);
+			} while (FindNextFileA(handle, &data));
+			FindClose(handle);
+		}
+#else
+		DIR* dir = opendir(_name.c_str());
+		if (dir)
+		{
+			struct dirent* entry;
+			while ((entry = readdir(dir)) != nullptr) names.push_back(entry->d_name);
+			closedir(dir);
+		}
+#endif
+		string next;
+		for (const auto& name : names)
+		{
+			if (name.empty() || name[0] == '.') continue;
+			string file = _name + "/" + name;
+			struct stat st;
+			if (stat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+			if (file > _file && (next.empty() || file < next)) next = file;
+		}
+		if (next.empty()) return false;
+
+		if (_is.is_open()) _is.close();
+		_is.clear();
+		_is.open(next.c_str(), ios::in | ios::binary);
+		_file = next;
+		_head = false;
+		if (_log) _log->comment(1, "gtail", "following " + _file);
+		return _is.is_open();
+	}
+
+	void t_gtail::_decode(char* buff, int size)
+	{
+		if (!_coder) return;
+
+		vector<string> errmsg;
+		if (!_head)
+		{
+			if (_coder->decode_head(buff, size, errmsg) < 0) _head = true;
+		}
+		else _coder->decode_data(buff, size, _count, errmsg);
+	}
+
+	void t_gtail::_report()
+	{
+		if (!_queue || !_rinexo) return;
+
+		t_gtime epo = _rinexo->fill_epoch();
+		if (epo > _reported)
+		{
+			_reported = epo;
+			if (!_queue->push(_path, epo)) _stop = 1;
+		}
+	}
+
+} // namespace
@@ -0,0 +1,101 @@
+/**
+ * @file         gtail.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        file io following a growing file, a FIFO or a directory of files
+ * @version      1.0
+ * @date         2024-10-17
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GTAIL_H
+#define GTAIL_H
+
+#include <fstream>
+#include <string>
+
+#include "gio/gio.h"
+#include "gutils/gepochqueue.h"
+
+// polling of the growing files [ms] and the chunk read at once (about an epoch,
+// the decoding is not far ahead of the epoch queue)
+#define TAIL_POLL  500
+#define TAIL_SIZE 4096
+
+using namespace std;
+
+namespace gnut
+{
+	class t_rinexo;
+
+	/**
+	* @brief reads the data appended to a file (or FIFO) as they arrive.
+	*
+	* If the path is a directory, its files are followed in the order of their names, the
+	* next file is started when the current one does not grow and a later one exists. Each
+	* file has its own header. The reading ends after the idle time without new data.
+	* The epochs filled by an observation decoder are reported to the epoch queue.
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gtail : public t_gio
+	{
+	public:
+		/** @brief default constructor. */
+		t_gtail();
+		virtual ~t_gtail();
+
+		/** @brief set the followed file or directory (file://dir/name accepted). */
+		virtual int path(string str);
+		virtual string path()const { return _path; }
+
+		/** @brief set the decoder, observations reported to the queue if any. */
+		virtual void coder(t_gcoder* coder);
+
+		/**
+		* @brief set the epoch queue the decoded epochs are reported to.
+		* @param[in]  queue      epoch queue, not owned
+		*/
+		void queue(t_gepochqueue* queue);
+
+		/** @brief set the idle time ending the reading [s]. */
+		void idle(double sec) { _idle = sec; }
+
+		/** @brief read the header of the first file, waits for it if not complete yet. */
+		virtual int init_read();
+
+		/** @brief read (and decode) the data until the idle time or the stop. */
+		virtual void run_read();
+
+	protected:
+		virtual int _gio_write(const char* buff, int size) { return -1; }
+
+		/**
+		* @brief read the available data, waits for more if none.
+		* @return
+			@retval >0    number of bytes read
+			@retval <=0   end of the data (idle time passed or stopped)
+		*/
+		virtual int _gio_read(char* buff, int size);
+
+		/** @brief open the next file of the directory (or the file itself). */
+		bool _next_file();
+
+		/** @brief decode the header or data. */
+		void _decode(char* buff, int size);
+
+		/** @brief report the last filled epoch to the queue. */
+		void _report();
+
+		string           _name;        ///< followed file or directory
+		bool             _dir;         ///< directory of files
+		string           _file;        ///< current file
+		ifstream         _is;          ///< current file stream
+		bool             _head;        ///< header of the current file decoded
+		double           _idle;        ///< idle time ending the reading [s]
+		t_gepochqueue*   _queue;       ///< epoch queue, not owned
+		t_rinexo*        _rinexo;      ///< observation decoder (for the filled epochs)
+		t_gtime          _reported;    ///< last reported epoch
+	};
+
+} // namespace
+
+#endif // GTAIL_H
@@ -10,6 +10,7 @@
  */
 #include "gmodels/greldelay.h"
 #include "gutils/gconst.h"
+#include <cmath>
 
 double great::t_reldelay_model::reldelay(t_gtriple& crd_site,t_gtriple& vel_site, t_gtriple& crd_sat, t_gtriple& vel_sat)
 { 
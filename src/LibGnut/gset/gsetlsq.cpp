@@ -8,10 +8,14 @@
  * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
  *
  */
+#include <algorithm>
+
 #include "gset/gsetlsq.h"
 
 gnut::t_gsetlsq::t_gsetlsq()
+	: t_gsetbase()
 {
+	_set.insert(XMLKEY_LSQ);
 }
 
 gnut::t_gsetlsq::~t_gsetlsq()
@@ -24,4 +28,46 @@ void gnut::t_gsetlsq::check()
 
 void gnut::t_gsetlsq::help()
 {
+	cerr << " <" << XMLKEY_LSQ << " solver=\"CHOLESKY\" ldlt_block=\"64\" selected_inverse=\"false\" temp_buffers=\"0\" />" << endl
+		 << endl;
+
+	cerr << "\t<solver> solver of NEQ (CHOLESKY/LDLT)" << endl
+		 << "\t<ldlt_block> size of the diagonal blocks in LDLT" << endl
+		 << "\t<selected_inverse> only compute the diagonal and the satellite clock block of Qx" << endl
+		 << "\t<temp_buffers> number of tempfile buffers written by a background thread (0: no thread)" << endl
+		 << endl;
+}
+
+gnut::LSQSOLVER gnut::t_gsetlsq::solver()
+{
+	_gmutex.lock();
+	string tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_LSQ).attribute("solver").value();
+	_gmutex.unlock();
+	transform(tmp.begin(), tmp.end(), tmp.begin(), ::toupper);
+	if (tmp == "LDLT") return LSQSOLVER::LDLT;
+	else return LSQSOLVER::CHOLESKY;
+}
+
+int gnut::t_gsetlsq::ldlt_block()
+{
+	_gmutex.lock();
+	int tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_LSQ).attribute("ldlt_block").as_int(64);
+	_gmutex.unlock();
+	return tmp;
+}
+
+bool gnut::t_gsetlsq::selected_inverse()
+{
+	_gmutex.lock();
+	bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_LSQ).attribute("selected_inverse").as_bool(false);
+	_gmutex.unlock();
+	return tmp;
+}
+
+int gnut::t_gsetlsq::temp_buffers()
+{
+	_gmutex.lock();
+	int tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_LSQ).attribute("temp_buffers").as_int(0);
+	_gmutex.unlock();
+	return tmp;
 }
@@ -8,10 +8,10 @@
  * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
  *
  */
-#ifndef GSETFLT_H
-#define GSETFLT_H
+#ifndef GSETLSQ_H
+#define GSETLSQ_H
 
-#define XMLKEY_FLT "filter"
+#define XMLKEY_LSQ "lsq"  ///< The defination of lsq node
 
 #include <string>
 #include <iostream>
@@ -24,6 +24,13 @@ using namespace std;
 
 namespace gnut
 {
+	/** @brief  enum for the solver of lsq NEQ */
+	enum class LSQSOLVER {
+		CHOLESKY,    ///< Eigen Cholesky with the full inverse
+		LDLT,        ///< blocked LDLT in place, only the diagonal of the inverse
+		LSQSOLVER_UNDEF
+	};
+
 	/// The class of settings for lsq estimator
 	class LibGnut_LIBRARY_EXPORT t_gsetlsq : public virtual t_gsetbase
 	{
@@ -34,6 +41,30 @@ namespace gnut
 		void check();                                  // settings check
 		void help();                                   // settings help
 
+		/**
+		* @brief get the solver of NEQ
+		* @return LSQSOLVER : CHOLESKY(default) or LDLT
+		*/
+		LSQSOLVER solver();
+
+		/**
+		* @brief get the size of the diagonal blocks in LDLT
+		* @return int : block size, default 64
+		*/
+		int ldlt_block();
+
+		/**
+		* @brief only the diagonal and the satellite clock block of the inverse are computed
+		* @return bool : default false
+		*/
+		bool selected_inverse();
+
+		/**
+		* @brief get the number of buffers of the tempfile written in background
+		* @return int : default 0, written in the calling thread (less than 2)
+		*/
+		int temp_buffers();
+
 	};
 
 } // namespace
@@ -1283,6 +1283,97 @@ bool t_gsetproc::matrix_remove() {
   return tmp;
 }
 
+bool t_gsetproc::neq_thread_reduce() {
+  _gmutex.lock();
+  bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("neq_thread_reduce").as_bool(false);
+  _gmutex.unlock();
+  return tmp;
+}
+
+bool t_gsetproc::sat_state_cache() {
+  _gmutex.lock();
+  bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("sat_state_cache").as_bool(false);
+  _gmutex.unlock();
+  return tmp;
+}
+
+bool t_gsetproc::trs2crs_interp() {
+  _gmutex.lock();
+  bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("trs2crs_interp").as_bool(false);
+  _gmutex.unlock();
+  return tmp;
+}
+
+double t_gsetproc::trs2crs_accuracy() {
+  _gmutex.lock();
+  double tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("trs2crs_accuracy").as_double(1e-11);
+  _gmutex.unlock();
+  return tmp;
+}
+
+bool t_gsetproc::obs_store() {
+  _gmutex.lock();
+  bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("obs_store").as_bool(false);
+  _gmutex.unlock();
+  return tmp;
+}
+
+bool t_gsetproc::rinexo_fast() {
+  _gmutex.lock();
+  bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("rinexo_fast").as_bool(false);
+  _gmutex.unlock();
+  return tmp;
+}
+
+string t_gsetproc::obs_cache() {
+  _gmutex.lock();
+  string tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("obs_cache").value();
+  _gmutex.unlock();
+  return tmp;
+}
+
+int t_gsetproc::slide_window() {
+  _gmutex.lock();
+  int tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("slide_window").as_int(0);
+  _gmutex.unlock();
+  return tmp < 0 ? 0 : tmp;
+}
+
+double t_gsetproc::replay_speed() {
+  _gmutex.lock();
+  double tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("replay_speed").as_double(0.0);
+  _gmutex.unlock();
+  return tmp < 0.0 ? 0.0 : tmp;
+}
+
+bool t_gsetproc::obs_stream() {
+  _gmutex.lock();
+  bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("obs_stream").as_bool(false);
+  _gmutex.unlock();
+  return tmp;
+}
+
+int t_gsetproc::stream_queue() {
+  _gmutex.lock();
+  int tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("stream_queue").as_int(60);
+  _gmutex.unlock();
+  return tmp < 1 ? 1 : tmp;
+}
+
+double t_gsetproc::stream_wait() {
+  _gmutex.lock();
+  double tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("stream_wait").as_double(10.0);
+  _gmutex.unlock();
+  return tmp < 0.0 ? 0.0 : tmp;
+}
+
+double t_gsetproc::stream_idle() {
+  _gmutex.lock();
+  double tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("stream_idle").as_double(600.0);
+  _gmutex.unlock();
+  return tmp < 0.0 ? 0.0 : tmp;
+}
+
 bool t_gsetproc::cmb_equ_multi_thread() {
   _gmutex.lock();
   bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_PROC).attribute("cmb_equ_multi_thread").as_bool(true);
@@ -194,6 +194,32 @@ class LibGnut_LIBRARY_EXPORT t_gsetproc : public virtual t_gsetbase {
   int num_threads();
   bool matrix_remove();
   bool cmb_equ_multi_thread();
+  /**@brief accumulate site NEQ blocks without lock and reduce them after the site loop */
+  bool neq_thread_reduce();
+  /**@brief compute satellite states once per epoch and share them with all sites */
+  bool sat_state_cache();
+  /**@brief interpolate TRS2CRS rotations from a table built for the processing window */
+  bool trs2crs_interp();
+  /**@brief max difference of the interpolated TRS2CRS rotation to the direct one [rad] */
+  double trs2crs_accuracy();
+  /**@brief move the observations of the sites into a columnar store read by the batch processing */
+  bool obs_store();
+  /**@brief decode the RINEX 3 observation records directly from the read buffer */
+  bool rinexo_fast();
+  /**@brief directory of the binary observation cache (empty = not used) */
+  string obs_cache();
+  /**@brief sliding window of the real-time clock estimation in epochs (0 = batch processing) */
+  int slide_window();
+  /**@brief replay speed of the observations in the sliding window, multiple of real time (0 = no waiting) */
+  double replay_speed();
+  /**@brief tail the observation files (or directories) as they grow, in the sliding window only */
+  bool obs_stream();
+  /**@brief number of epochs the streamed observations may be decoded ahead of the processing */
+  int stream_queue();
+  /**@brief seconds to wait for late sites once an epoch is decoded for the others */
+  double stream_wait();
+  /**@brief seconds without new data after which a streamed file is finished */
+  double stream_idle();
   /**@brief initial sigma */
   double sig_init_ztd();
   double sig_init_vion();
@@ -43,6 +43,12 @@ namespace great
 		return tmp;
 	}
 
+	bool t_gsetturboedit::innerMode()
+	{
+		bool tmp = _doc.child(XMLKEY_ROOT).child(XMLKEY_TURBOEDIT).attribute("inner_mode").as_bool();
+		return tmp;
+	}
+
 	bool t_gsetturboedit::isAmbOutput()
 	{
 		xml_node tmp_set = _doc.child(XMLKEY_ROOT).child(XMLKEY_TURBOEDIT).child("amb_output");
@@ -181,7 +187,7 @@ namespace great
 
 	void t_gsetturboedit::help()
 	{	
-		cerr << "<turboedit  lite_mode=\"false\" >" << endl
+		cerr << "<turboedit  lite_mode=\"false\"  inner_mode=\"false\" >" << endl
 			<< "<amb_output  valid=\"true\"  />  " << endl
 			<< "<simulation  valid=\"false\" />  " << endl
 			<< "<ephemeris   valid=\"true\"  />  " << endl
@@ -39,6 +39,8 @@ namespace great
 
 		bool liteMode();
 
+		bool innerMode();
+
 		bool isAmbOutput();
 
 		bool isEphemeris();
@@ -0,0 +1,99 @@
+/**
+ * @file         gepochqueue.cpp
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        bounded queue of the epochs decoded by the streamed sources
+ * @version      1.0
+ * @date         2024-10-17
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#include "gutils/gepochqueue.h"
+#include "gutils/gcommon.h"
+
+#include <chrono>
+
+namespace gnut
+{
+	t_gepochqueue::t_gepochqueue(const t_gtime& beg, double intv, int size, double wait) :
+		_intv(intv),
+		_size(size < 1 ? 1 : size),
+		_wait(wait),
+		_processed(beg - intv),
+		_stop(false)
+	{
+		gtrace("t_gepochqueue::construct");
+	}
+
+	void t_gepochqueue::add_source(const string& src)
+	{
+		lock_guard<mutex> lock(_mutex);
+		_decoded.insert(make_pair(src, _processed));
+	}
+
+	bool t_gepochqueue::push(const string& src, const t_gtime& epo)
+	{
+		unique_lock<mutex> lock(_mutex);
+		t_gtime& decoded = _decoded.insert(make_pair(src, _processed)).first->second;
+		if (epo > decoded) decoded = epo;
+		_cond.notify_all();
+
+		// the observations of epochs ahead are kept in memory, the source waits for the processing
+		while (!_stop && decoded.diff(_processed) > _size * _intv) _cond.wait(lock);
+		return !_stop;
+	}
+
+	void t_gepochqueue::finish(const string& src)
+	{
+		lock_guard<mutex> lock(_mutex);
+		_finished.insert(src);
+		_cond.notify_all();
+	}
+
+	bool t_gepochqueue::wait(const t_gtime& epo)
+	{
+		unique_lock<mutex> lock(_mutex);
+		_processed = epo - _intv;
+		_cond.notify_all();
+
+		bool waiting = false;
+		chrono::steady_clock::time_point deadline;
+		while (!_stop)
+		{
+			int nreached = 0, nlate = 0;
+			for (const auto& src : _decoded)
+			{
+				if (src.second >= epo) nreached++;
+				else if (_finished.find(src.first) == _finished.end()) nlate++;
+			}
+			if (nlate == 0) return nreached > 0;
+
+			// the late sources are waited for a limited time only, their observations are skipped
+			if (nreached > 0)
+			{
+				if (!waiting)
+				{
+					waiting = true;
+					deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(_wait));
+				}
+				if (_cond.wait_until(lock, deadline) == cv_status::timeout) return true;
+			}
+			else _cond.wait(lock);
+		}
+		return false;
+	}
+
+	void t_gepochqueue::stop()
+	{
+		lock_guard<mutex> lock(_mutex);
+		_stop = true;
+		_cond.notify_all();
+	}
+
+	int t_gepochqueue::active()
+	{
+		lock_guard<mutex> lock(_mutex);
+		return (int)(_decoded.size() - _finished.size());
+	}
+
+} // namespace
@@ -0,0 +1,86 @@
+/**
+ * @file         gepochqueue.h
+ * @author       GREAT-WHU (https://github.com/GREAT-WHU)
+ * @brief        bounded queue of the epochs decoded by the streamed sources
+ * @version      1.0
+ * @date         2024-10-17
+ *
+ * @copyright Copyright (c) 2024, Wuhan University. All rights reserved.
+ *
+ */
+#ifndef GEPOCHQUEUE_H
+#define GEPOCHQUEUE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+
+#include "gexport/ExportLibGnut.h"
+#include "gutils/gtime.h"
+
+using namespace std;
+
+namespace gnut
+{
+	/**
+	* @brief bounded queue between the readers of the streamed sources and the epoch loop.
+	*
+	* The decoded observations stay in their data container, the queue only keeps the last
+	* epoch decoded by each source. A reader is blocked when it is more than size epochs
+	* ahead of the processing, so the container holds a bounded number of epochs.
+	*/
+	class LibGnut_LIBRARY_EXPORT t_gepochqueue
+	{
+	public:
+		/**
+		* @brief constructor.
+		* @param[in]  beg        first epoch to be processed
+		* @param[in]  intv       sampling interval [s]
+		* @param[in]  size       number of epochs a source may be decoded ahead of the processing
+		* @param[in]  wait       time to wait for late sources once another one decoded the epoch [s]
+		*/
+		t_gepochqueue(const t_gtime& beg, double intv, int size, double wait);
+		virtual ~t_gepochqueue() {};
+
+		/** @brief register a source (before the processing starts). */
+		void add_source(const string& src);
+
+		/**
+		* @brief the source decoded all the epochs up to epo, blocks while the source is too far ahead.
+		* @return false if the queue was stopped
+		*/
+		bool push(const string& src, const t_gtime& epo);
+
+		/** @brief the source is finished, nothing more is decoded. */
+		void finish(const string& src);
+
+		/**
+		* @brief wait until the epoch is decoded by all the sources or the waiting time passed,
+		*        the previous epochs are processed.
+		* @return false if all the sources are finished before the epoch (or the queue was stopped)
+		*/
+		bool wait(const t_gtime& epo);
+
+		/** @brief stop the queue, all the waiting calls return. */
+		void stop();
+
+		/** @brief number of sources not finished yet. */
+		int active();
+
+	protected:
+		double                   _intv;         ///< sampling interval [s]
+		int                      _size;         ///< number of epochs decoded ahead
+		double                   _wait;         ///< waiting for late sources [s]
+		t_gtime                  _processed;    ///< last processed epoch
+		map<string, t_gtime>     _decoded;      ///< last decoded epoch of the sources
+		set<string>              _finished;     ///< finished sources
+		bool                     _stop;         ///< stop required
+		mutex                    _mutex;        ///< mutual exclusion
+		condition_variable       _cond;         ///< signal a change
+	};
+
+} // namespace
+
+#endif // GEPOCHQUEUE_H
@@ -1,5 +1,8 @@
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 #include "gcfg_pce.h"
 
@@ -46,7 +49,6 @@ int main(int argc, char** argv)
 	t_gallobs*    gobs = new t_gallobs();  gobs->glog(&glog); gobs->gset(&gset);
 	t_gallnav*    gorb = new t_gallprec(); gorb->glog(&glog);
 	dynamic_cast<t_gallprec*>(gorb)->use_clknav(true);
-	t_gdata*      gdata = nullptr;
 	t_gallpcv*    gpcv = nullptr; if (gset.input_size("atx") > 0) { gpcv = new t_gallpcv;  gpcv->glog(&glog); }
 	t_gallotl*    gotl = nullptr; if (gset.input_size("blq") > 0) { gotl = new t_gallotl;  gotl->glog(&glog); }
 	t_gallrecover*    grcv = new t_gallrecover(); grcv->glog(&glog);
@@ -80,23 +82,24 @@ int main(int argc, char** argv)
 		gset.usage();
 	}
 
-	// DATA READING
-	// for multiply thread
-	vector<t_gcoder*> gcoder_thrd;
-	vector<thread> gthread;
-	clock_t beg_time = clock();
-	clock_t end_time = clock();
-
-	multimap<IFMT, string>::const_iterator itINP = inp.begin();
-	for (size_t i = 0; i < inp.size() && itINP != inp.end(); ++i, ++itINP)
+	// streamed observations are followed while processed in the sliding window
+	bool obs_stream = dynamic_cast<t_gsetproc*>(&gset)->obs_stream();
+	bool slide_window = dynamic_cast<t_gsetproc*>(&gset)->slide_window() > 0 && dynamic_cast<t_gsetproc*>(&gset)->lsq_mode() == LSQMODE::EPO;
+	if (obs_stream && !slide_window)
 	{
-		// Get the file format/path, which will be used in decoder
-		IFMT   ifmt(itINP->first);
-		string path(itINP->second);
-		string id("ID" + int2str(i));
+		glog.comment(0, "main", "Warning: obs_stream needs slide_window in EPO mode, the rinexo files are read at once");
+		obs_stream = false;
+	}
+	vector<pair<t_gtail*, t_gcoder*> > streams;
+	mutex streams_mutex;
 
+	// DATA READING
+	// read one file with its own gcoder/gio into the matching container
+	auto read_file = [&](IFMT ifmt, const string& path, const string& id)
+	{
 		t_gio*    gio = nullptr;
 		t_gcoder* gcoder = nullptr;
+		t_gdata*  gdata = nullptr;
 
 		// For different file format, we prepare different data container and decoder for them.
 		if (ifmt == SP3_INP) { gdata = gorb; gcoder = new t_sp3(&gset, "", 8172); }
@@ -113,7 +116,7 @@ int main(int argc, char** argv)
 		else if (ifmt == LEAPSECOND_INP) { gdata = gleap; gcoder = new t_leapsecond(&gset, "", 4096); }
 		else {
 			glog.comment(0, "main", "Error: unrecognized format " + int2str(ifmt));
-			gdata = nullptr;
+			return;
 		}
 
 		// Check the file path
@@ -122,43 +125,124 @@ int main(int argc, char** argv)
 			glog.comment(0, "main", "path is file!");
 		}
 
-		// READ DATA FROM FILE
-		if (gcoder)
+		// FOLLOW THE STREAMED FILE (or directory), only the header is read now
+		if (ifmt == RINEXO_INP && obs_stream)
 		{
-			// get read time 
-			beg_time = clock();
-
-			gio = new t_gfile;
-			gio->glog(&glog);
-			gio->path(path);
+			t_gtail* gtail = new t_gtail;
+			gtail->glog(&glog);
+			gtail->path(path);
+			gtail->idle(dynamic_cast<t_gsetproc*>(&gset)->stream_idle());
 
-			// Put the file into gcoder
 			gcoder->clear();
 			gcoder->path(path);
 			gcoder->glog(&glog);
-			// Put the data container into gcoder
 			gcoder->add_data(id, gdata);
 			gcoder->add_data("OBJ", gobj);
-			// Put the gcoder into the gio
-			// Note, gcoder contain the gdata and gio contain the gcoder
-			gio->coder(gcoder);
-
-			runepoch = t_gtime::current_time(t_gtime::GPS);
-			// Read the data from file here
-			gio->run_read();
-			lstepoch = t_gtime::current_time(t_gtime::GPS);
-			// Write the information of reading process to log file
-			glog.comment(0, "main", "READ: " + path + " time: "
-				+ dbl2str(lstepoch.diff(runepoch)) + " sec");
-			if (gio) { delete gio; gio = nullptr; }
-			if (gcoder) { delete gcoder; gcoder = nullptr; }
-
-			// get read time 
-			end_time = clock();
-			cout << "Time for " + path + " is " << (end_time - beg_time) / CLOCKS_PER_SEC << " sec " << endl;
+			gtail->coder(gcoder);
+
+			if (gtail->init_read() <= 0) glog.comment(0, "main", "Warning: no header in the stream " + path);
+			glog.comment(0, "main", "STREAM: " + path);
+			lock_guard<mutex> lock(streams_mutex);
+			streams.push_back(make_pair(gtail, gcoder));
+			return;
 		}
+
+		// READ DATA FROM FILE
+		t_gfile* gfile = new t_gfile;
+		gio = gfile;
+		gio->glog(&glog);
+		gio->path(path);
+
+		// Put the file into gcoder
+		gcoder->clear();
+		gcoder->path(path);
+		gcoder->glog(&glog);
+		// Put the data container into gcoder
+		gcoder->add_data(id, gdata);
+		gcoder->add_data("OBJ", gobj);
+		// Put the gcoder into the gio
+		// Note, gcoder contain the gdata and gio contain the gcoder
+		gio->coder(gcoder);
+
+		// Read the data from file here
+		// (observations decoded in a previous run are read from the cache, if any)
+		steady_clock::time_point beg_file = steady_clock::now();
+		string cache_dir = dynamic_cast<t_gsetproc*>(&gset)->obs_cache();
+		if (ifmt == RINEXO_INP && !cache_dir.empty())
+		{
+			t_rinexo* rinexo = dynamic_cast<t_rinexo*>(gcoder);
+			string cache = cache_dir + "/" + rinexo->cache_name(gfile->md5sum());
+			if (rinexo->cache_read(cache) >= 0)
+			{
+				glog.comment(0, "main", "READ: " + path + " from cache " + cache);
+			}
+			else
+			{
+				rinexo->cache_record(true);
+				gio->run_read();
+				if (rinexo->cache_write(cache) < 0) glog.comment(0, "main", "Warning: cache not written " + cache);
+			}
+		}
+		else gio->run_read();
+		double read_sec = duration<double>(steady_clock::now() - beg_file).count();
+		// Write the information of reading process to log file
+		glog.comment(0, "main", "READ: " + path + " time: " + dbl2str(read_sec) + " sec");
+		if (gio) { delete gio; gio = nullptr; }
+		if (gcoder) { delete gcoder; gcoder = nullptr; }
+	};
+
+	// The formats are read one after the other in the order of IFMT, as later ones may
+	// complete the objects of earlier ones (e.g. SINEX after RINEXO). The files of one format
+	// are read in order, except RINEXO files of different sites, which are read concurrently.
+	int num_threads = max(1, dynamic_cast<t_gsetproc*>(&gset)->num_threads());
+	steady_clock::time_point beg_read = steady_clock::now();
+
+	multimap<IFMT, string>::const_iterator itINP = inp.begin();
+	size_t num_file = 0;
+	while (itINP != inp.end())
+	{
+		IFMT ifmt(itINP->first);
+
+		// group the files, a group is read by one thread in order
+		map<string, vector<pair<string, string> > > groups;
+		for (; itINP != inp.end() && itINP->first == ifmt; ++itINP, ++num_file)
+		{
+			string path(itINP->second);
+			string key;
+			if (ifmt == RINEXO_INP)
+			{
+				string name = path.substr(path.find_last_of("/\\") + 1);
+				key = name.substr(0, 4);
+				transform(key.begin(), key.end(), key.begin(), ::tolower);
+			}
+			groups[key].push_back(make_pair(path, "ID" + int2str(num_file)));
+		}
+
+		vector<vector<pair<string, string> >*> tasks;
+		for (auto& group : groups) tasks.push_back(&group.second);
+
+		atomic<int> next_task(0);
+		auto read_tasks = [&]()
+		{
+			for (int k = next_task++; k < (int)tasks.size(); k = next_task++)
+			{
+				for (const auto& file : *tasks[k]) read_file(ifmt, file.first, file.second);
+			}
+		};
+
+		vector<thread> gthread;
+		for (int k = 1; k < min(num_threads, (int)tasks.size()); k++) gthread.push_back(thread(read_tasks));
+		read_tasks();
+		for (auto& one_thread : gthread) one_thread.join();
 	}
 
+	double read_sec = duration<double>(steady_clock::now() - beg_read).count();
+	glog.comment(0, "main", "READ: " + int2str(num_file) + " files, " + int2str(num_threads) + " threads, time: " + dbl2str(read_sec) + " sec");
+	cout << "Time for reading " << num_file << " files is " << dbl2str(read_sec) << " sec " << endl;
+
+	// orbits and clocks are read-only from now on, query them without locks
+	dynamic_cast<t_gallprec*>(gorb)->freeze();
+
 	// set antennas for satllites (must be before PCV assigning)
 	// assigning PCV pointers to objects
 	t_gtime beg = dynamic_cast<t_gsetgen*>(&gset)->beg();
@@ -179,7 +263,6 @@ int main(int argc, char** argv)
 	// PROCESSING
 	vgclk = make_shared<t_gpcelsqIF>(&gset, data, &glog);
 	
-	vgclk->add_coder(gcoder_thrd);
 	t_gtime epo(t_gtime::GPS);
 
 	// Start write log for the processing 
@@ -189,9 +272,33 @@ int main(int argc, char** argv)
 	runepoch = t_gtime::current_time(t_gtime::GPS);
 	// Main processing function
 	cout << beg.str_ymdhms("  beg: ") << endl;
-	vgclk->ProcessBatch(data, beg, end);
+	if (slide_window && !streams.empty())
+	{
+		// the streams are decoded in their threads, bounded by the queue, while the epochs are processed
+		t_gepochqueue queue(beg, sample, dynamic_cast<t_gsetproc*>(&gset)->stream_queue(), dynamic_cast<t_gsetproc*>(&gset)->stream_wait());
+		for (auto& stream : streams) stream.first->queue(&queue);
+
+		vector<thread> readers;
+		for (auto& stream : streams) readers.push_back(thread(&t_gtail::run_read, stream.first));
+		dynamic_pointer_cast<t_gpcelsqIF>(vgclk)->ProcessWindow(data, beg, end, &queue);
 
-	vgclk->GenerateProduct();
+		queue.stop();
+		for (auto& stream : streams) stream.first->stop();
+		for (auto& reader : readers) reader.join();
+		for (auto& stream : streams) { delete stream.first; delete stream.second; }
+		streams.clear();
+	}
+	else if (slide_window)
+	{
+		// real-time clocks are written every epoch, there is no batch product
+		dynamic_pointer_cast<t_gpcelsqIF>(vgclk)->ProcessWindow(data, beg, end);
+	}
+	else
+	{
+		vgclk->ProcessBatch(data, beg, end);
+
+		vgclk->GenerateProduct();
+	}
 	// Get the time of duration 
 	lstepoch = t_gtime::current_time(t_gtime::GPS);
 	// Write finished log
@@ -201,8 +308,6 @@ int main(int argc, char** argv)
 	glog.comment(0, "main", " Normal End! ");
 	
 	// Delete pointer
-	for (size_t i = 0; i < gcoder_thrd.size(); ++i) { delete gcoder_thrd[i]; }; gcoder_thrd.clear();
-
 	if (gobs) { delete gobs; gobs = nullptr; }
 	if (gerp) { delete gerp; gerp = nullptr; }
 	if (gde) { delete gde; gde = nullptr; }
@@ -21,7 +21,8 @@ namespace gnut
    t_gsetpar(),
    t_gsetrec(),
    t_gsetturboedit(),
-   t_gsetflt()
+   t_gsetflt(),
+   t_gsetlsq()
 {
   _IFMT_supported.insert(RINEXO_INP);
   _IFMT_supported.insert(RINEXC_INP);
@@ -66,6 +67,7 @@ void t_gcfg_pce::check()
   t_gsetproc::check();
   t_gsetgnss::check();
   t_gsetamb::check();
+  t_gsetlsq::check();
 
 }
 
@@ -82,6 +84,7 @@ void t_gcfg_pce::help()
   t_gsetproc::help();
   t_gsetgnss::help();
   t_gsetamb::help();
+  t_gsetlsq::help();
   t_gsetbase::help_footer();
 }
 
@@ -16,6 +16,7 @@
 #include "gset/gsetamb.h"
 #include "gset/gsetturboedit.h"
 #include "gset/gsetflt.h"
+#include "gset/gsetlsq.h"
 
 #include "gall/gallproc.h"
 #include "gall/gallprec.h"
@@ -33,6 +34,7 @@
 #include "gcoders/dvpteph405.h"
 #include "gcoders/poleut1.h"
 #include "gio/gfile.h"
+#include "gio/gtail.h"
 
 using namespace std;
 using namespace pugi;
@@ -49,7 +51,8 @@ namespace gnut
 		public t_gsetamb,
 		public t_gsetrec,
 		public t_gsetturboedit,
-		public t_gsetflt
+		public t_gsetflt,
+		public t_gsetlsq
 	{
 
 	public: